@@ -11,6 +11,8 @@
 
 #include "HPCAnswer.hpp"
 #include "HPCMath.hpp"
+#include "HPCRandom.hpp"
+#include "HPCTimer.hpp"
 
 #include <vector>
 #include <list>
@@ -18,26 +20,374 @@
 #include <algorithm>
 #include <iterator>
 #include <limits>
+#include <queue>
+#include <functional>
 #include <cstdint>
+#include <cstdio>
+
+//make MEMORY=1 のときだけ，経路の表の確保をフィールドのキャッシュとして数える
+#ifdef HPC_MEMORY
+#include "HPCMemory.hpp"
+#endif
+
+//経路探索のベンチマーク(bench/HPCPathBench.cpp)がこのファイルを取り込むときだけ，探索で展開したノードを数える
+#ifdef HPC_PATH_BENCH
+#define HPC_COUNT_EXPANDED() (++hpc::search_expanded_count)
+#else
+#define HPC_COUNT_EXPANDED() ((void)0)
+#endif
 
 /// プロコン問題環境を表します。
 namespace hpc {
     class Path;
 
-    void choose_item(const Field& _field, const ItemCollection& _items);
+    //迷路に近いフィールドとみなす壁率[%]の下限(ポートフォリオの集計でステージを分けるのに使う)
+    static const int MazeWallRatioMin = 44;
+
+    void init_search(const Field& _field);
+
+    class PlanProblem;
+    typedef std::vector< std::vector<int> > Plan; //ピリオドごとの荷物の配達順
+
+    void build_problem(const Field& _field, const ItemCollection& _items, PlanProblem& _problem);
+    void choose_item(const PlanProblem& _problem, Plan& _plan);
+    void materialize(const Field& _field, const ItemCollection& _items, const Plan& _plan);
+    int get_detour(const PlanProblem& _problem, const std::vector<int>& _tour, const int _k, const int _item);
+
+    //荷物の挿入位置とその燃料の増分
+    struct Insertion
+    {
+        int cost;
+        int k;
+    };
+
+    //regret挿入法の候補 : regretが大きいもの，同じなら増分が小さいもの，同じなら番号の小さいものを優先
+    struct RegretEntry
+    {
+        int regret;
+        int cost;
+        int item;
+        int version;
+
+        bool operator<(const RegretEntry& _rhs)
+            const
+        {
+            if(regret != _rhs.regret)
+            {
+                return regret < _rhs.regret;
+            }
+            if(cost != _rhs.cost)
+            {
+                return cost > _rhs.cost;
+            }
+            return item > _rhs.item;
+        }
+    };
+
+    //regretで足りないピリオドの分として加える値(選択肢の少ない荷物を先に入れるため)
+    static const int RegretInfeasible = 1 << 20;
+    //regret挿入法で試すkの最小値(最大はピリオド数)
+    static const int RegretKMin = 2;
+
+    int get_period_cost(const PlanProblem& _problem, const std::vector<int>& _tour);
+    int get_plan_cost(const PlanProblem& _problem, const Plan& _plan);
+    Insertion get_best_insertion(const PlanProblem& _problem, const std::vector<int>& _tour, const int _load, const int _item);
+    bool regret_insertion(const PlanProblem& _problem, const Timer& _timer, const int _regret_k, const std::vector<int>& _items, Plan& _plan);
+    bool regret_insertion(const PlanProblem& _problem, const Timer& _timer, const int _regret_k, Plan& _plan);
+
+    //LNSの破壊の種類
+    enum LnsDestroy
+    {
+        LNS_DESTROY_DISTANCE, //迷路上で近いもの
+        LNS_DESTROY_PERIOD,   //同じピリオドのもの
+        LNS_DESTROY_WEIGHT,   //重さが近いもの
+
+        LnsDestroyCount
+    };
+
+    //LNSで一度に抜く荷物の最大数
+    static const int LnsRemoveMax = 5;
+    //LNSの1ステージあたりの反復回数
+    //荷物は高々ItemCountMax個で，一度に抜くのも高々LnsRemoveMax個なので，近傍はすぐに回りきる
+    //時間を十分に与えたとき，全ステージの合計は250回で頭打ちになり，4000回まで増やしても変わらない(実測)
+    static const int LnsIterationMax = 500;
+
+    void large_neighborhood_search(const PlanProblem& _problem, const Timer& _timer, const int _iteration_max, Random& _random, Plan& _plan);
+
+    //ポートフォリオの戦略(この順に走らせる)
+    enum PortfolioStrategy
+    {
+        STRATEGY_GREEDY,      //choose_item
+        STRATEGY_REGRET,      //regret-k挿入法
+        STRATEGY_MULTI_START, //乱択構築の多スタート
+        STRATEGY_EXACT,       //分枝限定法
+        STRATEGY_LNS,         //LNS
+
+        StrategyCount
+    };
+
+    //ステージの種類 : 迷路に近いか × 荷物数(4個ごと) × 時間帯指定の荷物が半分以上か
+    static const int StageClassItemStep = 4;
+    static const int StageClassCount    = 2 * (Parameter::ItemCountMax / StageClassItemStep) * 2;
+    //ハーネスから制限時間をもらえないときの，1ステージあたりの制限時間[秒]
+    //仕事量の上限だけで収まる長さにしてあり，打ち切りは遅いマシンでの安全のため
+    static const double PortfolioTimeLimitSec = 0.03;
+
+    int get_stage_class(const PlanProblem& _problem);
+    double get_time_limit(const Stage& _stage);
+    TimerMode get_timer_mode(const Stage& _stage);
+    PortfolioStrategy run_portfolio(const PlanProblem& _problem, const Timer& _timer, Plan& _plan);
+
+    //多スタート構築の回数，挿入コストに加える雑音の最大値[%]，乱数のシード(回ごとにXにスタート番号を足す)
+    static const int MultiStartCount = 8;
+    static const int MultiStartNoise = 20;
+    static const uint MultiStartSeedX = 0x6c078965;
+    static const uint MultiStartSeedY = 0x9908b0df;
+    static const uint MultiStartSeedZ = 0x1b873593;
+    static const uint MultiStartSeedW = 0xcc9e2d51;
+
+    //多スタート構築の作業領域(スタートごとに確保し直さない)
+    struct MultiStartScratch
+    {
+        Plan             plan;
+        std::vector<int> load;
+        std::vector<int> order;
+        std::vector<int> key;
+    };
+
+    bool randomized_construction(const PlanProblem& _problem, Random& _random, MultiStartScratch& _scratch);
+    void multi_start(const PlanProblem& _problem, const int _start_count, Plan& _plan);
+
+    //厳密解法を使う荷物数の上限と探索ノード数の上限
+    static const int ExactItemMax = 14;
+    static const int ExactNodeMax = 200000;
+    //厳密解法で制限時間を確かめる間隔(ノード数 - 1)
+    static const int ExactTimerCheckMask = 0xff;
+    static const int ExactInfeasible     = std::numeric_limits<int32_t>::max() / 2;
+
     std::vector<Action> gen_route(const Field& _field, const ItemCollection& _items, const std::list<int>& _load_index);
     std::list<int> convex_hull(const Field& _field, const ItemCollection& _items, const std::vector<int>& _load_index);
     std::vector<int> sort_position_y(const Field& _field, const ItemCollection& _items, const std::vector<int>& _target);
     const Pos get_pos(const Field& _field, const ItemCollection& _items, const int _index);
     int get_weight(const ItemCollection& _items, const int _index);
     int distance(const Pos& _a, const Pos& _b);
-    int get_delivery_cost(const std::list<Path>& _path, const int _weight, std::list<Path>::iterator _branch_timing, const Path& _add_path_start_to_cp, const Path& _add_path_cp_to_goal);
-    int get_delivery_cost(const int _weight, const Path& _add_path_start_to_cp, const Path& _add_path_cp_to_goal);
+
+#ifdef HPC_PATH_BENCH
+    long long search_expanded_count = 0; //展開したノード数(ベンチマーク用)
+#endif
+
+    namespace
+    {
+        bool is_maze_field = false;
+        bool wall_map[Parameter::FieldWidthMax * Parameter::FieldHeightMax]; //壁情報のキャッシュ(y * width + x)
+    };
+
+    //------------------------------------------------------------------------------
+    /// @brief フィールド上の任意のマスから任意のマスへの最初の一手と距離を引ける経路データベース
+    ///
+    /// 目的地ごとに1行を持ち，行は「各マスから目的地へ向かう最初の一手」をセル番号順に並べたものを
+    /// ランレングス圧縮して保持します．壁と目的地自身の手はどうでもよいので直前の手に揃え，ランを伸ばします．
+    /// 一手の問い合わせはランの二分探索でO(log)，距離は行ごとの表でO(1)です．
+    class PathDatabase
+    {
+    public:
+        PathDatabase()
+            :
+            m_width   (0),
+            m_height  (0),
+            m_row     (),
+            m_moves   (),
+            m_distance()
+        {
+        }
+
+        // フィールドを切り替える(既存の行はすべて捨てる)
+        // wall_mapはinit_searchで作成済みであること
+        void reset(const Field& _field)
+        {
+            m_width  = _field.width();
+            m_height = _field.height();
+            m_row.assign(m_width * m_height, -1);
+            m_moves.clear();
+            m_distance.clear();
+        }
+
+        // 目的地_toの行を作っておく
+        void prepare(const Pos& _to)
+        {
+            row(_to);
+        }
+
+        // _fromから_toへ向かう最初の一手
+        Action next_move(const Pos& _from, const Pos& _to)
+        {
+            const std::vector<Run>& buf_runs = m_moves[row(_to)];
+            const int cell = _from.y * m_width + _from.x;
+
+            //cell以下で最後に始まるランを探す
+            size_t lo = 0, hi = buf_runs.size();
+            while(hi - lo > 1)
+            {
+                const size_t mid = (lo + hi) / 2;
+                if(run_begin(buf_runs[mid]) <= cell)
+                {
+                    lo = mid;
+                }
+                else
+                {
+                    hi = mid;
+                }
+            }
+            return (Action)run_move(buf_runs[lo]);
+        }
+
+        // _fromから_toまでの最短距離
+        int distance(const Pos& _from, const Pos& _to)
+        {
+            return m_distance[row(_to)][_from.y * m_width + _from.x];
+        }
+
+        // _fromから_toまでの最短経路
+        std::list<Action> route(const Pos& _from, const Pos& _to)
+        {
+            std::list<Action> buf_return;
+            for(Pos here = _from; here != _to; here = here.move(buf_return.back()))
+            {
+                buf_return.push_back(next_move(here, _to));
+            }
+            return buf_return;
+        }
+
+        // 使用中のメモリ量[byte]
+        size_t byte_size()
+            const
+        {
+            size_t buf_return = m_row.capacity() * sizeof(int);
+            for(size_t s = 0, cond_s = m_moves.size(); s < cond_s; ++s)
+            {
+                buf_return += m_moves[s].capacity() * sizeof(Run) + m_distance[s].capacity() * sizeof(uint16_t);
+            }
+            return buf_return;
+        }
+
+    private:
+        //同じ手が続く区間 : 上位2bitが手，下位14bitが区間の先頭のセル番号
+        typedef uint16_t Run;
+        static const int RunMoveShift = 14;
+        static const int RunBeginMask = (1 << RunMoveShift) - 1;
+
+        static inline int run_begin(const Run _run)
+        {
+            return _run & RunBeginMask;
+        }
+
+        static inline int run_move(const Run _run)
+        {
+            return _run >> RunMoveShift;
+        }
+
+        // 目的地の行番号を返す．なければ目的地からのBFSで作る
+        int row(const Pos& _to)
+        {
+            const int target = _to.y * m_width + _to.x;
+            if(m_row[target] >= 0)
+            {
+                return m_row[target];
+            }
+
+            static const int cell_max = Parameter::FieldWidthMax * Parameter::FieldHeightMax;
+            int queue[cell_max];
+            const int cell_count = m_width * m_height;
+
+            std::vector<uint16_t> buf_distance(cell_count, std::numeric_limits<uint16_t>::max());
+
+            //目的地から距離を広げる
+            static const int offset[4] = {-1, 1, 0, 0};
+            int head = 0, tail = 0;
+            buf_distance[target] = 0;
+            queue[tail++] = target;
+            while(head < tail)
+            {
+                const int here = queue[head++];
+                HPC_COUNT_EXPANDED();
+                for(int i = 0; i < 4; ++i)
+                {
+                    const int next = here + (i < 2 ? offset[i] : (i == 2 ? -m_width : m_width));
+                    if(wall_map[next] || buf_distance[next] != std::numeric_limits<uint16_t>::max())
+                    {
+                        continue;
+                    }
+                    buf_distance[next] = buf_distance[here] + 1;
+                    queue[tail++] = next;
+                }
+            }
+
+            //セル番号順に最初の一手を決めてランレングス圧縮する
+            //最短となる手が複数あれば直前のランの手を優先してランを伸ばす．手の決まっていないマスは直前のランに吸収させる
+            std::vector<Run> buf_runs;
+            for(int c = 0; c < cell_count; ++c)
+            {
+                if(wall_map[c] || c == target)
+                {
+                    continue;
+                }
+                int buf_move = Action_TERM;
+                for(int i = 0; i < 4; ++i)
+                {
+                    const int next = c + (i < 2 ? offset[i] : (i == 2 ? -m_width : m_width));
+                    if(buf_distance[next] + 1 == buf_distance[c])
+                    {
+                        if(!buf_runs.empty() && run_move(buf_runs.back()) == i)
+                        {
+                            buf_move = i;
+                            break;
+                        }
+                        if(buf_move == Action_TERM)
+                        {
+                            buf_move = i;
+                        }
+                    }
+                }
+                if(buf_runs.empty() || run_move(buf_runs.back()) != buf_move)
+                {
+                    buf_runs.push_back((Run)((buf_move << RunMoveShift) | c));
+                }
+            }
+            if(buf_runs.empty())
+            {
+                buf_runs.push_back((Run)(Action_MoveLeft << RunMoveShift));
+            }
+            buf_runs.front() = (Run)(buf_runs.front() & ~RunBeginMask);
+            buf_runs.shrink_to_fit();
+
+            m_row[target] = (int)m_moves.size();
+            m_moves.push_back(std::vector<Run>());
+            m_moves.back().swap(buf_runs);
+            m_distance.push_back(std::vector<uint16_t>());
+            m_distance.back().swap(buf_distance);
+            return m_row[target];
+        }
+
+        int m_width;
+        int m_height;
+
+        std::vector<int>                     m_row;      //目的地のセル番号 -> 行番号(-1 : 未作成)
+        std::vector< std::vector<Run> >      m_moves;    //行ごとの最初の一手(ランレングス圧縮)
+        std::vector< std::vector<uint16_t> > m_distance; //行ごとの距離
+    };
+
+    namespace
+    {
+        PathDatabase path_db;
+    };
 
     //------------------------------------------------------------------------------
     /// @brief startからendまでの経路を示します
     class Path
     {
+#ifdef HPC_PATH_BENCH
+        friend class PathBench; //探索を直接呼んで計測する
+#endif
     public:
         int start;
         int goal;
@@ -45,6 +395,8 @@ namespace hpc {
         int load_weight;
         std::list<Action> route;
 
+        // 経路は全てpath_dbから引くので，個別の探索は経路探索のベンチマークで比べるときだけ残す
+#ifdef HPC_PATH_BENCH
     private:
         class AStar_dat
         {
@@ -188,6 +540,7 @@ namespace hpc {
                     }
                 }
                 buf_pos = open_nodes.at(buf_index)->m_pos;
+                HPC_COUNT_EXPANDED();
                 // スコア最小のノードの上下左右を探索する(OPENにする)
                 for(int i = 0; i < 4; ++i)
                 {
@@ -211,14 +564,245 @@ namespace hpc {
             }
         }
 
+        // セル番号(y * width + x)の親配列からPATH導出
+        static std::list<Action> gen_path(const int* _parent, const int _width, const int _start, const int _goal)
+        {
+            std::list<Action> buf_return;
+
+            for(int here = _goal; here != _start; here = _parent[here])
+            {
+                const int buf_diff = here - _parent[here];
+                if     (buf_diff ==  1)
+                {
+                    buf_return.push_front(Action_MoveRight);
+                }
+                else if(buf_diff == -1)
+                {
+                    buf_return.push_front(Action_MoveLeft);
+                }
+                else if(buf_diff ==  _width)
+                {
+                    buf_return.push_front(Action_MoveUp);
+                }
+                else
+                {
+                    buf_return.push_front(Action_MoveDown);
+                }
+            }
+
+            return buf_return;
+        }
+
+        // 幅優先探索
+        // 壁の少ない開けたフィールドでは，偶数座標の柱のせいでジャンプ点が増えるJPSより速い(実測)
+        std::list<Action> bfs(const Field& _field, const Pos& _start, const Pos& _goal)
+            const
+        {
+            if(_goal == _start)
+            {
+                return std::list<Action>();
+            }
+
+            static const int cell_max = Parameter::FieldWidthMax * Parameter::FieldHeightMax;
+            int parent[cell_max]; //到達元のセル番号(-1 : 未到達)
+            int queue [cell_max];
+
+            const int width = _field.width();
+            const int start_cell = _start.y * width + _start.x, goal_cell = _goal.y * width + _goal.x;
+            std::fill(parent, parent + width * _field.height(), -1);
+
+            int head = 0, tail = 0;
+            parent[start_cell] = start_cell;
+            queue[tail++] = start_cell;
+            while(head < tail)
+            {
+                const int here = queue[head++];
+                const Pos buf_pos(here % width, here / width);
+                HPC_COUNT_EXPANDED();
+                for(int i = 0; i < 4; ++i)
+                {
+                    const Pos buf_move = buf_pos.move((Action)i);
+                    const int next     = buf_move.y * width + buf_move.x;
+                    if(parent[next] != -1 || wall_map[next])
+                    {
+                        continue;
+                    }
+                    parent[next] = here;
+                    if(next == goal_cell)
+                    {
+                        return gen_path(parent, width, start_cell, goal_cell);
+                    }
+                    queue[tail++] = next;
+                }
+            }
+
+            return std::list<Action>();
+        }
+
+        // JPS : 縦方向のジャンプ
+        // 進行方向の横が開けていて，その一歩手前の横が壁ならば強制隣接点としてそこで止まる
+        static bool jump_vertical(const int _width, const int _x, int _y, const int _dy, const Pos& _goal, Pos& _jump)
+        {
+            const int step = _dy * _width;
+            for(int here = _y * _width + _x; ; )
+            {
+                here += step;
+                _y   += _dy;
+                if(wall_map[here])
+                {
+                    return false;
+                }
+                if((_x == _goal.x && _y == _goal.y) ||
+                   (!wall_map[here - 1] && wall_map[here - 1 - step]) ||
+                   (!wall_map[here + 1] && wall_map[here + 1 - step]))
+                {
+                    _jump = Pos(_x, _y);
+                    return true;
+                }
+            }
+        }
+
+        // JPS : 横方向のジャンプ
+        // 横移動を先に行う経路を正規形とするので，1歩ごとに上下へのジャンプを試し，見つかればそこで止まる
+        static bool jump_horizontal(const int _width, int _x, const int _y, const int _dx, const Pos& _goal, Pos& _jump)
+        {
+            Pos buf_jump;
+            while(true)
+            {
+                _x += _dx;
+                if(wall_map[_y * _width + _x])
+                {
+                    return false;
+                }
+                if((_x == _goal.x && _y == _goal.y) ||
+                   jump_vertical(_width, _x, _y,  1, _goal, buf_jump) ||
+                   jump_vertical(_width, _x, _y, -1, _goal, buf_jump))
+                {
+                    _jump = Pos(_x, _y);
+                    return true;
+                }
+            }
+        }
+
+        // Jump Point Search (4近傍，一様コスト)
+        // 状態は(セル, 到達した軸)の組で持つ．同じセルでも横から来たか縦から来たかで次に伸ばす方向が変わるため
+        std::list<Action> jump_point_search(const Field& _field, const Pos& _start, const Pos& _goal)
+            const
+        {
+            if(_goal == _start)
+            {
+                return std::list<Action>();
+            }
+
+            static const int state_max = Parameter::FieldWidthMax * Parameter::FieldHeightMax * 2;
+            int  cost  [state_max];
+            int  parent[state_max];
+            bool closed[state_max];
+
+            const int width = _field.width();
+            std::fill(cost,   cost   + width * _field.height() * 2, std::numeric_limits<int32_t>::max());
+            std::fill(closed, closed + width * _field.height() * 2, false);
+
+            typedef std::pair<int, int> Node; //(スコア, 状態番号)
+            std::priority_queue<Node, std::vector<Node>, std::greater<Node> > open_nodes;
+
+            const int start_state = (_start.y * width + _start.x) * 2;
+            cost  [start_state] = 0;
+            parent[start_state] = -1;
+            open_nodes.push(Node(distance(_start, _goal), start_state));
+
+            Pos buf_jump;
+            while(!open_nodes.empty())
+            {
+                const int here = open_nodes.top().second;
+                open_nodes.pop();
+                if(closed[here])
+                {
+                    continue;
+                }
+                closed[here] = true;
+                HPC_COUNT_EXPANDED();
+
+                const Pos buf_pos((here / 2) % width, (here / 2) / width);
+                if(buf_pos == _goal)
+                {
+                    //ジャンプ点間は直線なので，1マスずつの親配列に展開してから経路にする
+                    int buf_parent[state_max / 2];
+                    for(int s = here; parent[s] != -1; s = parent[s])
+                    {
+                        const int from = parent[s] / 2, to = s / 2;
+                        const int step = (to / width == from / width) ? (to > from ? 1 : -1) : (to > from ? width : -width);
+                        for(int c = to; c != from; c -= step)
+                        {
+                            buf_parent[c] = c - step;
+                        }
+                    }
+                    return gen_path(buf_parent, width, start_state / 2, here / 2);
+                }
+
+                //伸ばす方向を決める
+                int dir_x[2] = {0, 0}, dir_y[2] = {0, 0};
+                if(parent[here] == -1)
+                {
+                    dir_x[0] = -1; dir_x[1] = 1;
+                    dir_y[0] = -1; dir_y[1] = 1;
+                }
+                else if(here % 2 == 0)
+                {
+                    //横から来た : 同じ向きに横，上下両方
+                    dir_x[0] = (buf_pos.x > (parent[here] / 2) % width) ? 1 : -1;
+                    dir_y[0] = -1; dir_y[1] = 1;
+                }
+                else
+                {
+                    //縦から来た : 同じ向きに縦，強制隣接点のある横
+                    const int dy = (buf_pos.y > (parent[here] / 2) / width) ? 1 : -1, cell = here / 2;
+                    dir_y[0] = dy;
+                    if(!wall_map[cell - 1] && wall_map[cell - 1 - dy * width])
+                    {
+                        dir_x[0] = -1;
+                    }
+                    if(!wall_map[cell + 1] && wall_map[cell + 1 - dy * width])
+                    {
+                        dir_x[1] = 1;
+                    }
+                }
+
+                for(int i = 0; i < 4; ++i)
+                {
+                    const int dx = i < 2 ? dir_x[i] : 0, dy = i < 2 ? 0 : dir_y[i - 2];
+                    if(dx == 0 && dy == 0)
+                    {
+                        continue;
+                    }
+                    if(dx != 0 ? !jump_horizontal(width, buf_pos.x, buf_pos.y, dx, _goal, buf_jump)
+                               : !jump_vertical  (width, buf_pos.x, buf_pos.y, dy, _goal, buf_jump))
+                    {
+                        continue;
+                    }
+                    const int next      = (buf_jump.y * width + buf_jump.x) * 2 + (dx != 0 ? 0 : 1);
+                    const int next_cost = cost[here] + distance(buf_pos, buf_jump);
+                    if(!closed[next] && next_cost < cost[next])
+                    {
+                        cost  [next] = next_cost;
+                        parent[next] = here;
+                        open_nodes.push(Node(next_cost + distance(buf_jump, _goal), next));
+                    }
+                }
+            }
+
+            return std::list<Action>();
+        }
+#endif
+
     public:
-        // A*を用いてstartからgoalまでの経路導出
+        // 経路データベースを引いてstartからgoalまでの経路導出
         Path(const Field& _field ,const ItemCollection& _item ,const int _start, const int _goal)
             :
             start      (_start),
             goal       (_goal),
             load_weight(get_weight(_item, _goal)),
-            route      (a_star(_field, get_pos(_field, _item, _start), get_pos(_field, _item, _goal)))
+            route      (path_db.route(get_pos(_field, _item, _start), get_pos(_field, _item, _goal)))
         {
         }
 
@@ -271,24 +855,343 @@ namespace hpc {
         }
     };
 
-    namespace 
+    //------------------------------------------------------------------------------
+    /// @brief 積載計画の問題を表します
+    ///
+    /// 計画段階では経路を持たず，荷物の重さ・指定時間帯と，配達先(+営業所)間の距離だけで考えます．
+    /// 距離表の番号は荷物番号で，最後(item_count)が営業所です．
+    class PlanProblem
     {
-        std::vector<Action> action[Parameter::PeriodCount];
-        std::list<int>      load_index[Parameter::PeriodCount];
-        int    period;
-        size_t act_index;
-    };
+    public:
+        int item_count;
+        int office;
+        int truck_weight;
+        int capacity;
+        int period_count;
 
+        std::vector<int> weight;
+        std::vector<int> period; //指定時間帯(-1 : 指定なし)
+        std::vector<int> dist;   //(item_count + 1)^2 の距離表
 
-    //------------------------------------------------------------------------------
-    /// 各ステージ開始時に呼び出されます。
+        inline int distance(const int _a, const int _b)
+            const
+        {
+            return dist[_a * (item_count + 1) + _b];
+        }
+    };
+
+    //------------------------------------------------------------------------------
+    /// @brief 積載計画の厳密解法(分枝限定法)
+    ///
+    /// ピリオド内の最適な配達順は，残りの荷物の集合と現在地から営業所に帰るまでの最小燃料
+    /// h(R, j) = min_x (トラック + Rの重さ) * d(j, x) + h(R - x, x) の動的計画法で求めます．
+    /// これは積載量の上限以下の集合だけで計算すれば足ります．
+    /// 荷物のピリオドへの割り当ては重い順に分枝し，
+    /// 下界 Σ_p h(S_p, 営業所) + Σ_未割り当て 重さ * d(営業所, x) を暫定解と比べて枝を刈ります．
+    /// (荷物を足しても燃料は減らず，足した荷物は少なくとも営業所から配達先まで運ばれるため，下界は正しい)
+    /// 空のピリオドは互いに区別がないので，最初の1つだけを試します．
+    /// ノード数か制限時間で打ち切った場合はそれまでの最良解を返します．
+    class ExactPlanner
+    {
+    public:
+        ExactPlanner(const PlanProblem& _problem, const Timer& _timer, const int _node_max)
+            :
+            m_problem   (_problem),
+            m_timer     (_timer),
+            m_node_max  (_node_max),
+            m_node_count(0),
+            m_is_timeout(false),
+            m_mask_load (),
+            m_cost      (),
+            m_free      (),
+            m_rest_bound(),
+            m_mask      (_problem.period_count, 0),
+            m_load      (_problem.period_count, 0),
+            m_best_mask (),
+            m_best_cost (0)
+        {
+        }
+
+        //_planを暫定解として探索し，より良い計画が見つかれば書き換える
+        //@return 最適性を証明できたか(打ち切らずに探索し終えたか)
+        bool solve(Plan& _plan)
+        {
+            const int item_count = m_problem.item_count, point_count = item_count + 1;
+            if(item_count > ExactItemMax)
+            {
+                return false;
+            }
+
+            //集合ごとの重さと，積める集合についてのh(R, j)
+            const int mask_count = 1 << item_count;
+            m_mask_load.assign(mask_count, 0);
+            m_cost.assign(mask_count * point_count, ExactInfeasible);
+            for(int mask = 1; mask < mask_count; ++mask)
+            {
+                const int low = lowest_bit(mask);
+                m_mask_load[mask] = m_mask_load[mask & (mask - 1)] + m_problem.weight[low];
+            }
+            for(int j = 0; j < point_count; ++j)
+            {
+                m_cost[j] = m_problem.truck_weight * m_problem.distance(j, m_problem.office);
+            }
+            for(int mask = 1; mask < mask_count; ++mask)
+            {
+                //表が作り終わらなければ何もしない
+                if((mask & ExactTimerCheckMask) == 0 && !m_timer.isInTime())
+                {
+                    m_is_timeout = true;
+                    return false;
+                }
+                if(m_mask_load[mask] > m_problem.capacity)
+                {
+                    continue;
+                }
+                const int carry = m_problem.truck_weight + m_mask_load[mask];
+                for(int j = 0; j < point_count; ++j)
+                {
+                    int buf_min = ExactInfeasible;
+                    for(int rest = mask; rest != 0; rest &= rest - 1)
+                    {
+                        const int x = lowest_bit(rest);
+                        buf_min = Math::Min(buf_min, carry * m_problem.distance(j, x) + m_cost[(mask & ~(1 << x)) * point_count + x]);
+                    }
+                    m_cost[mask * point_count + j] = buf_min;
+                }
+            }
+
+            //指定のある荷物は最初から割り当て，指定のない荷物を重い順に分枝する
+            m_free.clear();
+            for(int s = 0; s < item_count; ++s)
+            {
+                if(m_problem.period[s] == -1)
+                {
+                    m_free.push_back(s);
+                }
+                else
+                {
+                    m_mask[m_problem.period[s]] |= 1 << s;
+                    m_load[m_problem.period[s]] += m_problem.weight[s];
+                }
+            }
+            std::stable_sort(m_free.begin(), m_free.end(), [&](const int _a, const int _b){ return m_problem.weight[_a] > m_problem.weight[_b]; });
+            m_rest_bound.assign(m_free.size() + 1, 0);
+            for(int i = (int)m_free.size() - 1; i >= 0; --i)
+            {
+                m_rest_bound[i] = m_rest_bound[i + 1] + m_problem.weight[m_free[i]] * m_problem.distance(m_problem.office, m_free[i]);
+            }
+
+            int buf_cost = 0;
+            for(int t = 0; t < m_problem.period_count; ++t)
+            {
+                if(m_load[t] > m_problem.capacity)
+                {
+                    return false;
+                }
+                buf_cost += period_cost(m_mask[t]);
+            }
+
+            m_best_cost  = get_plan_cost(m_problem, _plan);
+            m_best_mask.clear();
+            m_node_count = 0;
+            m_is_timeout = false;
+            branch(0, buf_cost);
+
+            if(!m_best_mask.empty())
+            {
+                for(int t = 0; t < m_problem.period_count; ++t)
+                {
+                    gen_tour(m_best_mask[t], _plan[t]);
+                }
+            }
+            return !m_is_timeout;
+        }
+
+    private:
+        //空のピリオドから営業所に帰るまでの燃料を0とした，集合_maskのピリオドの最小燃料
+        inline int period_cost(const int _mask)
+            const
+        {
+            return m_cost[_mask * (m_problem.item_count + 1) + m_problem.office];
+        }
+
+        static int lowest_bit(const int _mask)
+        {
+            int buf_bit = 0;
+            while(!(_mask & (1 << buf_bit)))
+            {
+                ++buf_bit;
+            }
+            return buf_bit;
+        }
+
+        //指定のない荷物のi番目以降を割り当てる
+        //一度打ち切ったら，残りの兄弟も含めてどの分枝も開かずに戻る
+        void branch(const int _i, const int _cost)
+        {
+            if(m_is_timeout)
+            {
+                return;
+            }
+            if(++m_node_count > m_node_max || ((m_node_count & ExactTimerCheckMask) == 0 && !m_timer.isInTime()))
+            {
+                m_is_timeout = true;
+                return;
+            }
+            if(_i == (int)m_free.size())
+            {
+                if(_cost < m_best_cost)
+                {
+                    m_best_cost = _cost;
+                    m_best_mask = m_mask;
+                }
+                return;
+            }
+
+            //燃料の増分の小さいピリオドから試す
+            const int s = m_free[_i];
+            std::pair<int, int> buf_child[Parameter::PeriodCount];
+            int  child_count = 0;
+            bool empty_is_searched = false;
+            for(int t = 0; t < m_problem.period_count; ++t)
+            {
+                if(m_load[t] + m_problem.weight[s] > m_problem.capacity)
+                {
+                    continue;
+                }
+                if(m_mask[t] == 0)
+                {
+                    if(empty_is_searched)
+                    {
+                        continue;
+                    }
+                    empty_is_searched = true;
+                }
+                const int buf_cost = _cost - period_cost(m_mask[t]) + period_cost(m_mask[t] | (1 << s));
+                if(buf_cost + m_rest_bound[_i + 1] >= m_best_cost)
+                {
+                    continue;
+                }
+                //高々ピリオド数個なので挿入ソートで並べる
+                int c = child_count++;
+                for(; c > 0 && buf_child[c - 1].first > buf_cost; --c)
+                {
+                    buf_child[c] = buf_child[c - 1];
+                }
+                buf_child[c] = std::make_pair(buf_cost, t);
+            }
+
+            for(int c = 0; c < child_count; ++c)
+            {
+                //暫定解が良くなっていれば刈り直す
+                if(buf_child[c].first + m_rest_bound[_i + 1] >= m_best_cost)
+                {
+                    break;
+                }
+                const int t = buf_child[c].second;
+                m_mask[t] |= 1 << s;
+                m_load[t] += m_problem.weight[s];
+                branch(_i + 1, buf_child[c].first);
+                m_mask[t] &= ~(1 << s);
+                m_load[t] -= m_problem.weight[s];
+            }
+        }
+
+        //集合_maskの最適な配達順をh(R, j)から復元する
+        void gen_tour(const int _mask, std::vector<int>& _tour)
+            const
+        {
+            const int point_count = m_problem.item_count + 1;
+            _tour.clear();
+            for(int rest = _mask, here = m_problem.office; rest != 0;)
+            {
+                const int carry = m_problem.truck_weight + m_mask_load[rest];
+                int min_x = -1;
+                for(int buf_rest = rest; buf_rest != 0; buf_rest &= buf_rest - 1)
+                {
+                    const int x = lowest_bit(buf_rest);
+                    if(carry * m_problem.distance(here, x) + m_cost[(rest & ~(1 << x)) * point_count + x] == m_cost[rest * point_count + here])
+                    {
+                        min_x = x;
+                        break;
+                    }
+                }
+                _tour.push_back(min_x);
+                rest &= ~(1 << min_x);
+                here  = min_x;
+            }
+        }
+
+        const PlanProblem& m_problem;
+        const Timer&       m_timer;
+        const int          m_node_max;
+        int                m_node_count;
+        bool               m_is_timeout; //ノード数か時間の上限で探索を打ち切ったか
+
+        std::vector<int> m_mask_load;  //[集合] 重さの合計
+        std::vector<int> m_cost;       //[集合 * (item_count + 1) + 現在地] h(R, j)
+        std::vector<int> m_free;       //指定のない荷物(重い順)
+        std::vector<int> m_rest_bound; //[i] 指定のない荷物のi番目以降の下界
+        std::vector<int> m_mask;       //[ピリオド] 割り当て中の集合
+        std::vector<int> m_load;       //[ピリオド] 割り当て中の重さ
+        std::vector<int> m_best_mask;
+        int              m_best_cost;
+    };
+
+    namespace 
+    {
+        std::vector<Action> action[Parameter::PeriodCount];
+        std::list<int>      load_index[Parameter::PeriodCount];
+        int    period;
+        size_t act_index;
+#ifdef DEBUG
+        int    portfolio_wins[StageClassCount][StrategyCount]; //[ステージの種類][戦略] 勝った回数
+#endif
+#if defined(DEBUG) && defined(HPC_PORTFOLIO_REPORT)
+        int    finished_stage_count = 0;
+#endif
+    };
+
+
+    //------------------------------------------------------------------------------
+    /// 各ステージ開始時に呼び出されます。
     ///
     /// ここで、各ステージに対して初期処理を行うことができます。
     ///
     /// @param[in] aStage 現在のステージ。
     void Answer::Init(const Stage& aStage)
     {
-        choose_item(aStage.field(), aStage.items());
+        //経路の表の準備も含めて制限時間内に収める
+        const double time_limit = get_time_limit(aStage);
+        Timer        buf_timer(time_limit, get_timer_mode(aStage));
+        buf_timer.start();
+
+        {
+#ifdef HPC_MEMORY
+            MemoryTagScope buf_tag(MemoryTag_FieldCache);
+#endif
+            init_search(aStage.field());
+
+            //営業所と配達先への行は必ず引くので先に作っておく
+            path_db.reset(aStage.field());
+            path_db.prepare(aStage.field().officePos());
+            for(int s = 0, cond_s = aStage.items().count(); s < cond_s; ++s)
+            {
+                path_db.prepare(aStage.items()[s].destination());
+            }
+        }
+
+        PlanProblem buf_problem;
+        Plan        buf_plan;
+        build_problem(aStage.field(), aStage.items(), buf_problem);
+        const PortfolioStrategy winner = run_portfolio(buf_problem, buf_timer, buf_plan);
+#ifdef DEBUG
+        ++portfolio_wins[get_stage_class(buf_problem)][winner];
+#else
+        (void)winner;
+#endif
+
+        materialize(aStage.field(), aStage.items(), buf_plan);
         //std::cout << "num. of item : " << aStage.items().count() << std::endl;
         
     }
@@ -360,188 +1263,644 @@ namespace hpc {
             load_index[s].clear();
             action[s].clear();
         }
+
+#if defined(DEBUG) && defined(HPC_PORTFOLIO_REPORT)
+        //全ステージが終わったら，ステージの種類ごとに勝った戦略を出す(使われない戦略を削る判断用)
+        if(++finished_stage_count == Parameter::GameStageCount)
+        {
+            static const char* const strategy_name[StrategyCount] = {"greedy", "regret", "multi", "exact", "lns"};
+            std::fprintf(stderr, "class(maze,items,fixed)");
+            for(int k = 0; k < StrategyCount; ++k)
+            {
+                std::fprintf(stderr, " %7s", strategy_name[k]);
+            }
+            std::fprintf(stderr, "\n");
+            for(int c = 0; c < StageClassCount; ++c)
+            {
+                std::fprintf(stderr, "%5d,%2d-%2d,%5d      ", c / (StageClassCount / 2), c / 2 % (Parameter::ItemCountMax / StageClassItemStep) * StageClassItemStep + 1,
+                             (c / 2 % (Parameter::ItemCountMax / StageClassItemStep) + 1) * StageClassItemStep, c % 2);
+                for(int k = 0; k < StrategyCount; ++k)
+                {
+                    std::fprintf(stderr, " %7d", portfolio_wins[c][k]);
+                }
+                std::fprintf(stderr, "\n");
+            }
+        }
+#endif
     }
 
 
     //------------------------------------------------------------------------------
     //以下，追加関数
     
+    //積載計画問題の作成
+    //荷物の配達先と営業所の間の距離を経路データベースから引いて表にする
+    void build_problem(const Field& _field, const ItemCollection& _items, PlanProblem& _problem)
+    {
+        _problem.item_count   = _items.count();
+        _problem.office       = _items.count();
+        _problem.truck_weight = Parameter::TruckWeight;
+        _problem.capacity     = Parameter::TruckWeightCapacity;
+        _problem.period_count = Parameter::PeriodCount;
+        _problem.weight.resize(_problem.item_count);
+        _problem.period.resize(_problem.item_count);
+        for(int s = 0; s < _problem.item_count; ++s)
+        {
+            _problem.weight[s] = _items[s].weight();
+            _problem.period[s] = _items[s].period();
+        }
+
+        const int point_count = _problem.item_count + 1;
+        _problem.dist.resize(point_count * point_count);
+        for(int s = 0; s < point_count; ++s)
+        {
+            for(int t = 0; t < point_count; ++t)
+            {
+                _problem.dist[s * point_count + t] = path_db.distance(get_pos(_field, _items, s), get_pos(_field, _items, t));
+            }
+        }
+    }
+
+
     //積載物選択
-    //4ピリオドの荷物全部決定する
-    void choose_item(const Field& _field, const ItemCollection& _items)
-    {
-        static int      capacity = Parameter::TruckWeight + Parameter::TruckWeightCapacity;
-        std::list<int>  free_item[Parameter::ItemWeightMax];
-        std::list<Path> delivery_cost[Parameter::PeriodCount];
-        int             inital_weight[Parameter::PeriodCount] = {Parameter::TruckWeight, Parameter::TruckWeight, Parameter::TruckWeight, Parameter::TruckWeight};
-        int             buf_weight;
-
-        int min_diff = std::numeric_limits<int32_t>::max();
-        std::list<Path>::iterator min_it;
-        Path min_start_to_s, min_s_to_goal;
-        Path buf_start_to_s, buf_s_to_goal;
-        int buf_cost = get_delivery_cost(delivery_cost[period], inital_weight[period], delivery_cost[period].end(), buf_start_to_s, buf_s_to_goal);
+    //全ピリオドの荷物と配達順を距離だけで決定する(経路は作らない)
+    void choose_item(const PlanProblem& _problem, Plan& _plan)
+    {
+        const int        capacity = _problem.truck_weight + _problem.capacity;
+        std::vector<int> free_item[Parameter::ItemWeightMax];
+        std::vector<int> inital_weight(_problem.period_count, _problem.truck_weight);
+        std::vector<int> length       (_problem.period_count, 0);
+        int              buf_weight;
+
+        int min_diff;
+        int min_k;
         int buf_diff;
         int period;
 
+        _plan.assign(_problem.period_count, std::vector<int>());
+
         //各ピリオドで配達することを指定されているものはとりあえず載せる
-        for(int s = 0, cond_s = _items.count(); s < cond_s; ++s)
+        //既に荷物があれば，最も遠回りの少ない区間に割り込ませる
+        for(int s = 0, cond_s = _problem.item_count; s < cond_s; ++s)
         {
-            if(_items[s].period() == -1)
+            if(_problem.period[s] == -1)
             {
-                free_item[_items[s].weight() - 1].push_back(s);
+                free_item[_problem.weight[s] - 1].push_back(s);
             }
             else
             {
+                period   = _problem.period[s];
                 min_diff = std::numeric_limits<int32_t>::max();
-                period = _items[s].period();
-
-                if(load_index[period].empty())
+                min_k    = 0;
+                for(int k = 0, cond_k = (int)_plan[period].size() + 1; k < cond_k && !_plan[period].empty(); ++k)
                 {
-                    delivery_cost[period].push_back(Path(_field, _items, _items.count(), s));
-                    inital_weight[period] += delivery_cost[period].back().load_weight;
-                    delivery_cost[period].push_back(Path(_field, _items, s, _items.count()));
-                    inital_weight[period] += delivery_cost[period].back().load_weight;
-                }
-                else
-                {
-                    buf_cost = get_delivery_cost(delivery_cost[period], inital_weight[period], delivery_cost[period].end(), buf_start_to_s, buf_s_to_goal);
-                    buf_weight = inital_weight[period] + get_weight(_items, s);
-
-                    for(std::list<Path>::iterator it = delivery_cost[period].begin(), cond_it = delivery_cost[period].end(); it != cond_it; ++it)
+                    if(min_diff > (buf_diff = get_detour(_problem, _plan[period], k, s)))
                     {
-                        if(min_diff > (buf_diff = get_delivery_cost(delivery_cost[period], buf_weight, it, (buf_start_to_s = Path(_field, _items, it->start, s)), (buf_s_to_goal = Path(_field, _items, s, it->goal))) - buf_cost))
-                        {
-                            min_diff = buf_diff;
-                            min_it = it;
-                            min_start_to_s = buf_start_to_s;
-                            min_s_to_goal  = buf_s_to_goal;
-                        }
+                        min_diff = buf_diff;
+                        min_k    = k;
                     }
-                    min_it = delivery_cost[period].erase(min_it);
-                    min_it = delivery_cost[period].insert(min_it, min_s_to_goal);
-                    min_it = delivery_cost[period].insert(min_it, min_start_to_s);
-                    inital_weight[period] = buf_weight;
                 }
-                load_index[period].push_back(s);
-
+                length[period] += get_detour(_problem, _plan[period], min_k, s);
+                _plan[period].insert(_plan[period].begin() + min_k, s);
+                inital_weight[period] += _problem.weight[s];
             }
         }
-        
+
         //時間帯指定なしの荷物を，重いものから載せていく
-        //載せるピリオドが決まっているものから最近傍点を導出し，その点と同じピリオドに載せることにする
-        int min_period, target_weight = Parameter::ItemWeightMax;
+        //全ピリオドの全区間に割り込ませたときの燃料の増分が最小となるところに載せる(空のピリオドは1つだけ試す)
+        int  min_period, buf_cost;
         bool empty_is_searched;
         for(int i = Parameter::ItemWeightMax - 1; i >= 0; --i)
         {
-            while(!free_item[i].empty())
+            for(size_t f = 0, cond_f = free_item[i].size(); f < cond_f; ++f)
             {
+                const int s = free_item[i][f];
                 empty_is_searched = false;
                 min_period = 0;
+                min_k      = 0;
                 min_diff   = std::numeric_limits<int32_t>::max();
-                min_it     = delivery_cost[min_period].end();
 
-                for(int t = 0; t < Parameter::PeriodCount; ++t)
+                for(int t = 0; t < _problem.period_count; ++t)
                 {
-                    if(capacity < (buf_weight = inital_weight[t] + target_weight))
+                    if(capacity < (buf_weight = inital_weight[t] + _problem.weight[s]))
                     {
                         continue;
                     }
 
-                    if(load_index[t].empty() && !empty_is_searched)
+                    if(_plan[t].empty())
                     {
-                        if(min_diff > (buf_diff = get_delivery_cost(buf_weight, (buf_start_to_s = Path(_field, _items, _items.count(), free_item[i].front())), (buf_s_to_goal = Path(_field, _items, free_item[i].front(), _items.count())))))
+                        if(!empty_is_searched && min_diff > (buf_diff = get_detour(_problem, _plan[t], 0, s) * buf_weight))
                         {
-                            min_diff       = buf_diff;
-                            min_period     = t;
-                            min_it         = delivery_cost[t].end();
-                            min_start_to_s = buf_start_to_s;
-                            min_s_to_goal  = buf_s_to_goal;
+                            min_diff   = buf_diff;
+                            min_period = t;
+                            min_k      = 0;
                         }
                         empty_is_searched = true;
                     }
                     else
                     {
-                        buf_cost = get_delivery_cost(delivery_cost[t], inital_weight[t], delivery_cost[t].end(), buf_start_to_s, buf_s_to_goal);
-                        for(std::list<Path>::iterator it = delivery_cost[t].begin(), cond_it = delivery_cost[t].end(); it != cond_it; ++it)
+                        buf_cost = length[t] * inital_weight[t];
+                        for(int k = 0, cond_k = (int)_plan[t].size() + 1; k < cond_k; ++k)
                         {
-                            if(min_diff > (buf_diff = get_delivery_cost(delivery_cost[t], buf_weight, it, (buf_start_to_s = Path(_field, _items, it->start, free_item[i].front())), (buf_s_to_goal = Path(_field, _items, free_item[i].front(), it->goal ))) - buf_cost))
+                            if(min_diff > (buf_diff = (length[t] + get_detour(_problem, _plan[t], k, s)) * buf_weight - buf_cost))
                             {
-                                min_diff       = buf_diff;
-                                min_period     = t;
-                                min_it         = it;
-                                min_start_to_s = buf_start_to_s;
-                                min_s_to_goal  = buf_s_to_goal;
+                                min_diff   = buf_diff;
+                                min_period = t;
+                                min_k      = k;
                             }
                         }
                     }
                 }
-                
-                load_index[min_period].push_back(free_item[i].front());
-                if(min_it != delivery_cost[min_period].end())
+
+                length[min_period] += get_detour(_problem, _plan[min_period], min_k, s);
+                _plan[min_period].insert(_plan[min_period].begin() + min_k, s);
+                inital_weight[min_period] += _problem.weight[s];
+            }
+        }
+
+        return;
+    }
+
+
+    //ピリオドの配達順にかかる燃料
+    //営業所で全部積んで出発し，配達するごとに軽くなって最後に営業所へ戻る
+    int get_period_cost(const PlanProblem& _problem, const std::vector<int>& _tour)
+    {
+        int buf_weight = _problem.truck_weight, buf_return = 0, here = _problem.office;
+        for(size_t k = 0, cond_k = _tour.size(); k < cond_k; ++k)
+        {
+            buf_weight += _problem.weight[_tour[k]];
+        }
+        for(size_t k = 0, cond_k = _tour.size(); k <= cond_k; ++k)
+        {
+            const int next = k < cond_k ? _tour[k] : _problem.office;
+            buf_return += _problem.distance(here, next) * buf_weight;
+            buf_weight -= next == _problem.office ? 0 : _problem.weight[next];
+            here        = next;
+        }
+        return buf_return;
+    }
+
+
+    //計画全体にかかる燃料
+    int get_plan_cost(const PlanProblem& _problem, const Plan& _plan)
+    {
+        int buf_return = 0;
+        for(size_t t = 0, cond_t = _plan.size(); t < cond_t; ++t)
+        {
+            buf_return += get_period_cost(_problem, _plan[t]);
+        }
+        return buf_return;
+    }
+
+
+    //配達順_tour(積載重量_load)に荷物_itemを割り込ませるとき，燃料の増分が最小となる位置
+    //k番目の区間に入れると，それより前の区間すべてで_itemの重さを余計に運び，区間自体は遠回りになる
+    Insertion get_best_insertion(const PlanProblem& _problem, const std::vector<int>& _tour, const int _load, const int _item)
+    {
+        Insertion buf_return = {std::numeric_limits<int32_t>::max(), 0};
+        const int item_weight = _problem.weight[_item];
+
+        int buf_weight = _problem.truck_weight + _load, buf_distance = 0, prev = _problem.office;
+        for(int k = 0, cond_k = (int)_tour.size(); k <= cond_k; ++k)
+        {
+            const int next     = k < cond_k ? _tour[k] : _problem.office;
+            const int to_item  = _problem.distance(prev, _item);
+            const int buf_cost = item_weight * (buf_distance + to_item) + buf_weight * (to_item + _problem.distance(_item, next) - _problem.distance(prev, next));
+            if(buf_return.cost > buf_cost)
+            {
+                buf_return.cost = buf_cost;
+                buf_return.k    = k;
+            }
+            buf_distance += _problem.distance(prev, next);
+            buf_weight   -= next == _problem.office ? 0 : _problem.weight[next];
+            prev          = next;
+        }
+        return buf_return;
+    }
+
+
+    //regret-k挿入法による積載計画の構築
+    //未割り当ての荷物ごとに全ピリオドへの最良挿入コストを持ち，最良とk番目までとの差(regret)が最大の荷物から入れる
+    //挿入で変わるのはそのピリオドの経路だけなので，キャッシュはそのピリオドの列だけ計算し直す
+    //時間帯指定のある荷物は選択肢が1つしかないので，regretが最大となり最初に入る
+    //_planに途中までの計画を渡せば，_itemsだけを追加で入れる(LNSの修復に使う)
+    //荷物が多いと1回でも重いので，1個入れるごとに_timerを確かめ，制限時間を過ぎたら途中でやめる
+    //@return 全荷物を積み切れたか(途中でやめたときはfalse)
+    bool regret_insertion(const PlanProblem& _problem, const Timer& _timer, const int _regret_k, const std::vector<int>& _items, Plan& _plan)
+    {
+        const int item_count = _problem.item_count, period_count = _problem.period_count;
+
+        std::vector<int>       load    (period_count, 0);
+        std::vector<Insertion> best    (item_count * period_count); //[荷物 * period_count + ピリオド]
+        std::vector<int>       version (item_count, 0);
+        std::priority_queue<RegretEntry> candidates;
+        std::vector<int>       buf_costs;
+        std::vector<bool>      assigned(item_count, true);
+
+        for(size_t i = 0, cond_i = _items.size(); i < cond_i; ++i)
+        {
+            assigned[_items[i]] = false;
+        }
+        for(int t = 0; t < period_count; ++t)
+        {
+            for(size_t k = 0, cond_k = _plan[t].size(); k < cond_k; ++k)
+            {
+                load[t] += _problem.weight[_plan[t][k]];
+            }
+            for(size_t i = 0, cond_i = _items.size(); i < cond_i; ++i)
+            {
+                best[_items[i] * period_count + t] = get_best_insertion(_problem, _plan[t], load[t], _items[i]);
+            }
+        }
+
+        //荷物_itemの候補を作る．載せられるピリオドがなければfalse
+        std::function<bool(int)> push_candidate = [&](const int _item) -> bool
+        {
+            buf_costs.clear();
+            for(int t = 0; t < period_count; ++t)
+            {
+                if((_problem.period[_item] == -1 || _problem.period[_item] == t) && load[t] + _problem.weight[_item] <= _problem.capacity)
+                {
+                    buf_costs.push_back(best[_item * period_count + t].cost);
+                }
+            }
+            if(buf_costs.empty())
+            {
+                return false;
+            }
+            std::sort(buf_costs.begin(), buf_costs.end());
+
+            RegretEntry buf_entry = {0, buf_costs.front(), _item, version[_item]};
+            for(int j = 1; j < _regret_k; ++j)
+            {
+                buf_entry.regret += j < (int)buf_costs.size() ? buf_costs[j] - buf_costs.front() : RegretInfeasible;
+            }
+            candidates.push(buf_entry);
+            return true;
+        };
+
+        for(size_t i = 0, cond_i = _items.size(); i < cond_i; ++i)
+        {
+            if(!push_candidate(_items[i]))
+            {
+                return false;
+            }
+        }
+
+        for(size_t placed = 0, cond_placed = _items.size(); placed < cond_placed; ++placed)
+        {
+            if(!_timer.isInTime())
+            {
+                return false;
+            }
+
+            //古くなった候補を捨てる
+            while(assigned[candidates.top().item] || version[candidates.top().item] != candidates.top().version)
+            {
+                candidates.pop();
+            }
+            const int s = candidates.top().item;
+            candidates.pop();
+
+            //最良のピリオドに入れる
+            int min_period = -1;
+            for(int t = 0; t < period_count; ++t)
+            {
+                if((_problem.period[s] == -1 || _problem.period[s] == t) && load[t] + _problem.weight[s] <= _problem.capacity &&
+                   (min_period == -1 || best[s * period_count + t].cost < best[s * period_count + min_period].cost))
                 {
-                    min_it = delivery_cost[min_period].erase(min_it);
+                    min_period = t;
                 }
-                min_it = delivery_cost[min_period].insert(min_it, min_s_to_goal);
-                min_it = delivery_cost[min_period].insert(min_it, min_start_to_s);
-                inital_weight[min_period] += target_weight;
+            }
+            _plan[min_period].insert(_plan[min_period].begin() + best[s * period_count + min_period].k, s);
+            load[min_period] += _problem.weight[s];
+            assigned[s] = true;
 
-                free_item[i].pop_front();
+            //変わったピリオドの列だけ計算し直す
+            for(size_t i = 0, cond_i = _items.size(); i < cond_i; ++i)
+            {
+                const int u = _items[i];
+                if(assigned[u])
+                {
+                    continue;
+                }
+                best[u * period_count + min_period] = get_best_insertion(_problem, _plan[min_period], load[min_period], u);
+                ++version[u];
+                if(!push_candidate(u))
+                {
+                    return false;
+                }
             }
-            --target_weight;
         }
 
+        return true;
+    }
+
+
+    //regret-k挿入法で空の計画から全荷物を入れる
+    bool regret_insertion(const PlanProblem& _problem, const Timer& _timer, const int _regret_k, Plan& _plan)
+    {
+        std::vector<int> buf_items(_problem.item_count);
+        for(int s = 0; s < _problem.item_count; ++s)
+        {
+            buf_items[s] = s;
+        }
+        _plan.assign(_problem.period_count, std::vector<int>());
+        return regret_insertion(_problem, _timer, _regret_k, buf_items, _plan);
+    }
+
+
+    //乱択の最安挿入法による積載計画の構築(結果は_scratch.plan)
+    //時間帯指定のある荷物を先に，指定のない荷物はおおむね重い順に入れる(重さの近いもの同士は順番を乱す)
+    //挿入コストには最大MultiStartNoise[%]の雑音を乗せ，ピリオドの選び方を揺らす
+    //@return 全荷物を積み切れたか
+    bool randomized_construction(const PlanProblem& _problem, Random& _random, MultiStartScratch& _scratch)
+    {
+        const int item_count = _problem.item_count, period_count = _problem.period_count;
 
-        //巡回ルートのアクションを各ピリオド用のグローバル変数に投げる
-        for(int i = 0; i < Parameter::PeriodCount; ++i)
+        _scratch.plan.resize(period_count);
+        _scratch.load.assign(period_count, 0);
+        _scratch.order.resize(item_count);
+        _scratch.key.resize(item_count);
+        for(int t = 0; t < period_count; ++t)
         {
-            for(std::list<Path>::iterator it = delivery_cost[i].begin(), cond_it = delivery_cost[i].end(); it != cond_it; ++it)
+            _scratch.plan[t].clear();
+        }
+        for(int s = 0; s < item_count; ++s)
+        {
+            _scratch.order[s] = s;
+            _scratch.key[s]   = (_problem.period[s] == -1 ? 0 : 1 << 8) + _problem.weight[s] * 4 + _random.randTerm(6);
+        }
+        std::sort(_scratch.order.begin(), _scratch.order.end(), [&](const int _a, const int _b)
+        {
+            return _scratch.key[_a] != _scratch.key[_b] ? _scratch.key[_a] > _scratch.key[_b] : _a < _b;
+        });
+
+        for(int i = 0; i < item_count; ++i)
+        {
+            const int s = _scratch.order[i];
+            int       min_period = -1, min_cost = 0;
+            Insertion min_insertion = {0, 0};
+            for(int t = 0; t < period_count; ++t)
+            {
+                if((_problem.period[s] != -1 && _problem.period[s] != t) || _scratch.load[t] + _problem.weight[s] > _problem.capacity)
+                {
+                    continue;
+                }
+                const Insertion buf_insertion = get_best_insertion(_problem, _scratch.plan[t], _scratch.load[t], s);
+                const int       buf_cost      = buf_insertion.cost * (100 + _random.randTerm(MultiStartNoise + 1));
+                if(min_period == -1 || buf_cost < min_cost)
+                {
+                    min_period    = t;
+                    min_cost      = buf_cost;
+                    min_insertion = buf_insertion;
+                }
+            }
+            if(min_period == -1)
             {
-                //std::cout << "add in period " << i << "(size : " << it->cost() << "), (" << get_pos(_field, _items, it->start).x << ", " << get_pos(_field, _items, it->start).y << ")->(" << get_pos(_field, _items, it->goal).x << ", " << get_pos(_field, _items, it->goal).y << ")" << std::endl;
-                action[i].insert(action[i].end(), it->route.begin(), it->route.end());
+                return false;
             }
+            _scratch.plan[min_period].insert(_scratch.plan[min_period].begin() + min_insertion.k, s);
+            _scratch.load[min_period] += _problem.weight[s];
         }
 
-        return;
+        return true;
     }
 
 
-    //ピリオド単位の輸送コスト導出
-    //_add_path_index = end()ならば追加なしの経路コスト導出, それ以外ならばしかるべき場所で_add_pathを経由した経路のコスト導出
-    int get_delivery_cost(const std::list<Path>& _path, const int _weight, std::list<Path>::iterator _branch_timing, const Path& _add_path_start_to_cp, const Path& _add_path_cp_to_goal)
+    //乱択構築を_start_count回行い，_planより安いものがあれば最も安いものに置き換える
+    //スタートごとに独立した乱数列を使うので，結果は回す順番によらない
+    //解答ではスレッドを使えないので，スタートを並列には走らせず逐次に回す
+    //スタートどうしは作業領域しか共有しないので，スレッドが使える環境ならスタートごとに作業領域を持たせて分ければよい
+    void multi_start(const PlanProblem& _problem, const int _start_count, Plan& _plan)
     {
-        int buf_return = 0, buf_weight = _weight;
+        MultiStartScratch buf_scratch;
+        int               min_cost = get_plan_cost(_problem, _plan);
+        for(int start = 0; start < _start_count; ++start)
+        {
+            Random buf_random(MultiStartSeedX + start, MultiStartSeedY, MultiStartSeedZ, MultiStartSeedW);
+            if(!randomized_construction(_problem, buf_random, buf_scratch))
+            {
+                continue;
+            }
+            const int buf_cost = get_plan_cost(_problem, buf_scratch.plan);
+            if(buf_cost < min_cost)
+            {
+                min_cost = buf_cost;
+                _plan    = buf_scratch.plan;
+            }
+        }
+    }
+
+
+    //ポートフォリオの結果を集計するステージの種類
+    int get_stage_class(const PlanProblem& _problem)
+    {
+        int fixed_count = 0;
+        for(int s = 0; s < _problem.item_count; ++s)
+        {
+            fixed_count += _problem.period[s] == -1 ? 0 : 1;
+        }
+        return ((is_maze_field ? 1 : 0) * (Parameter::ItemCountMax / StageClassItemStep) + (_problem.item_count - 1) / StageClassItemStep) * 2 +
+               (fixed_count * 2 >= _problem.item_count ? 1 : 0);
+    }
+
+
+    //このステージで計画に使える時間[秒]
+    //ハーネスが全体の制限時間から割り振った時間があればそれを，なければ既定値を使う
+    double get_time_limit(const Stage& _stage)
+    {
+#ifdef HPC_STAGE_SOLVE_TIME_LIMIT
+        if(_stage.solveTimeLimitSec() > 0.0)
+        {
+            return _stage.solveTimeLimitSec();
+        }
+#endif
+        return PortfolioTimeLimitSec;
+    }
+
+
+    //このステージの制限時間を測る方法
+    //ハーネスが割り振った時間はゲームの制限時間と同じ方法で測るので，それに合わせる
+    TimerMode get_timer_mode(const Stage& _stage)
+    {
+#ifdef HPC_STAGE_TIMER_MODE
+        return _stage.timerMode();
+#else
+        (void)_stage;
+        return TimerMode_ProcessCpu;
+#endif
+    }
 
-        for(std::list<Path>::const_iterator it = _path.cbegin(), cond_it = _path.cend(); it != cond_it; ++it)
+
+    //戦略を順に走らせ，最も安い計画を_planに入れる
+    //各戦略の仕事量は回数(ExactNodeMax, LnsIterationMax など)で決めるので，結果は実行ごとの時間のぶれによらない
+    //_timerは安全のための上限で，これを過ぎたら残りの戦略は打ち切る．分枝限定法が最適性を証明したときも打ち切る
+    //(解答ではスレッドを使えないので，戦略を同時には走らせず1つずつ走らせる)
+    //@return 最終的な計画を作った戦略
+    PortfolioStrategy run_portfolio(const PlanProblem& _problem, const Timer& _timer, Plan& _plan)
+    {
+        PortfolioStrategy winner = STRATEGY_GREEDY;
+        choose_item(_problem, _plan);
+        int min_cost = get_plan_cost(_problem, _plan);
+
+        //戦略を走らせた後で安くなっていれば勝者を書き換える
+        auto update_winner = [&](const PortfolioStrategy _strategy)
         {
-            if(it == _branch_timing)
+            const int buf_cost = get_plan_cost(_problem, _plan);
+            if(buf_cost < min_cost)
             {
-                buf_return += _add_path_start_to_cp.cost() * _weight;
-                buf_weight -= _add_path_start_to_cp.load_weight;
+                min_cost = buf_cost;
+                winner   = _strategy;
+            }
+        };
 
-                buf_return += _add_path_cp_to_goal.cost() * _weight;
-                buf_weight -= _add_path_cp_to_goal.load_weight;
+        Plan buf_regret_plan;
+        for(int k = RegretKMin; k <= _problem.period_count && _timer.isInTime(); ++k)
+        {
+            if(regret_insertion(_problem, _timer, k, buf_regret_plan) && get_plan_cost(_problem, buf_regret_plan) < min_cost)
+            {
+                _plan.swap(buf_regret_plan);
+                update_winner(STRATEGY_REGRET);
             }
-            else
+        }
+
+        if(_timer.isInTime())
+        {
+            multi_start(_problem, MultiStartCount, _plan);
+            update_winner(STRATEGY_MULTI_START);
+        }
+
+        if(_timer.isInTime())
+        {
+            const bool is_optimal = ExactPlanner(_problem, _timer, ExactNodeMax).solve(_plan);
+            update_winner(STRATEGY_EXACT);
+            if(is_optimal)
             {
-                buf_return += it->cost() * _weight;
-                buf_weight -= it->load_weight;
+                return winner;
             }
         }
-        return buf_return;
+
+        if(_timer.isInTime())
+        {
+            Random buf_random; //既定のシードで作るので，同じステージには毎回同じ破壊と修復を試す
+            large_neighborhood_search(_problem, _timer, LnsIterationMax, buf_random, _plan);
+            update_winner(STRATEGY_LNS);
+        }
+
+        return winner;
     }
 
 
-    int get_delivery_cost(const int _weight, const Path& _add_path_start_to_cp, const Path& _add_path_cp_to_goal)
+    //LNS(破壊と修復の繰り返し)による改善
+    //関連の強い荷物のまとまり(迷路上で近い，同じピリオド，重さが近い)を抜き，regret挿入法で入れ直す
+    //燃料が増えなければ受理する(同じ燃料の計画へも動けるようにする)
+    //_iteration_max回か_timerの制限時間に達したら終わり
+    void large_neighborhood_search(const PlanProblem& _problem, const Timer& _timer, const int _iteration_max, Random& _random, Plan& _plan)
     {
-        int buf_return = 0, buf_weight = _weight;
+        const int item_count = _problem.item_count;
+        if(item_count < 2)
+        {
+            return;
+        }
 
-        buf_return += _add_path_start_to_cp.cost() * _weight;
-        buf_weight -= _add_path_start_to_cp.load_weight;
+        int  current_cost = get_plan_cost(_problem, _plan);
+        Plan buf_plan;
+        std::vector<int> buf_removed, buf_order(item_count), buf_relation(item_count);
 
-        buf_return += _add_path_cp_to_goal.cost() * _weight;
+        for(int iteration = 0; iteration < _iteration_max && _timer.isInTime(); ++iteration)
+        {
+            //破壊 : 種となる荷物との関連度の小さい順にremove_count個抜く
+            const int seed         = _random.randTerm(item_count);
+            const int remove_count = _random.randMinMax(2, Math::Min(LnsRemoveMax, item_count));
+            const int destroy      = _random.randTerm(LnsDestroyCount);
 
-        return buf_return;
+            int seed_period = 0;
+            for(int t = 0; t < _problem.period_count; ++t)
+            {
+                if(std::find(_plan[t].begin(), _plan[t].end(), seed) != _plan[t].end())
+                {
+                    seed_period = t;
+                }
+            }
+            for(int t = 0; t < _problem.period_count; ++t)
+            {
+                for(size_t k = 0, cond_k = _plan[t].size(); k < cond_k; ++k)
+                {
+                    const int s = _plan[t][k];
+                    switch(destroy)
+                    {
+                    case LNS_DESTROY_DISTANCE:
+                        buf_relation[s] = _problem.distance(seed, s);
+                        break;
+                    case LNS_DESTROY_PERIOD:
+                        //別のピリオドの荷物は，どれだけ近くても同じピリオドの荷物より後にする
+                        buf_relation[s] = (t == seed_period ? 0 : Parameter::FieldWidthMax * Parameter::FieldHeightMax) + _problem.distance(seed, s);
+                        break;
+                    default:
+                        buf_relation[s] = Math::Abs(_problem.weight[seed] - _problem.weight[s]) * _problem.dist.size() + _random.randTerm(item_count);
+                        break;
+                    }
+                }
+            }
+            for(int s = 0; s < item_count; ++s)
+            {
+                buf_order[s] = s;
+            }
+            std::stable_sort(buf_order.begin(), buf_order.end(), [&](const int _a, const int _b){ return buf_relation[_a] < buf_relation[_b]; });
+            buf_removed.assign(buf_order.begin(), buf_order.begin() + remove_count);
+
+            buf_plan = _plan;
+            for(int t = 0; t < _problem.period_count; ++t)
+            {
+                buf_plan[t].erase(std::remove_if(buf_plan[t].begin(), buf_plan[t].end(), [&](const int _s){ return std::find(buf_removed.begin(), buf_removed.end(), _s) != buf_removed.end(); }), buf_plan[t].end());
+            }
+
+            //修復 : kもランダムに選ぶ(k = 1 は単純な最安挿入)
+            if(!regret_insertion(_problem, _timer, _random.randMinMax(1, _problem.period_count), buf_removed, buf_plan))
+            {
+                continue;
+            }
+
+            const int buf_cost = get_plan_cost(_problem, buf_plan);
+            if(buf_cost <= current_cost)
+            {
+                current_cost = buf_cost;
+                _plan.swap(buf_plan);
+            }
+        }
+    }
+
+
+    //決定した計画から積載物とアクションを各ピリオド用のグローバル変数に投げる
+    //経路データベースで最初の一手を辿り，区間ごとに一度だけアクション列を作る
+    void materialize(const Field& _field, const ItemCollection& _items, const Plan& _plan)
+    {
+        for(int i = 0, cond_i = (int)_plan.size(); i < cond_i; ++i)
+        {
+            int here = _items.count();
+            for(size_t k = 0, cond_k = _plan[i].size(); k <= cond_k; ++k)
+            {
+                const int next = k < cond_k ? _plan[i][k] : _items.count();
+                const std::list<Action> buf_route = path_db.route(get_pos(_field, _items, here), get_pos(_field, _items, next));
+                action[i].insert(action[i].end(), buf_route.begin(), buf_route.end());
+                if(k < cond_k)
+                {
+                    load_index[i].push_back(next);
+                }
+                here = next;
+            }
+        }
+    }
+
+
+    //ピリオドの配達順_tourのk番目の区間(k - 1番目とk番目の間)に荷物_itemを割り込ませたときの遠回りの量
+    int get_detour(const PlanProblem& _problem, const std::vector<int>& _tour, const int _k, const int _item)
+    {
+        const int prev = _k == 0                 ? _problem.office : _tour[_k - 1];
+        const int next = _k == (int)_tour.size() ? _problem.office : _tour[_k];
+        return _problem.distance(prev, _item) + _problem.distance(_item, next) - _problem.distance(prev, next);
     }
 
 
@@ -561,6 +1920,27 @@ namespace hpc {
     {
         return Math::Abs(_b.x - _a.x) + Math::Abs(_b.y - _a.y);
     }
+
+
+    //壁情報をキャッシュし，フィールドが迷路に近いかを壁率から判定する
+    void init_search(const Field& _field)
+    {
+        int wall_count = 0, cell_count = 0;
+        for(int y = 0, cond_y = _field.height(); y < cond_y; ++y)
+        {
+            for(int x = 0, cond_x = _field.width(); x < cond_x; ++x)
+            {
+                wall_map[y * cond_x + x] = _field.isWall(x, y);
+                if(0 < x && x < cond_x - 1 && 0 < y && y < cond_y - 1)
+                {
+                    wall_count += wall_map[y * cond_x + x] ? 1 : 0;
+                    ++cell_count;
+                }
+            }
+        }
+
+        is_maze_field = wall_count * 100 >= cell_count * MazeWallRatioMin;
+    }
 }
 
 //------------------------------------------------------------------------------
@@ -0,0 +1,90 @@
+//------------------------------------------------------------------------------
+/// @file
+/// @brief HPCDeadline.hpp の実装
+/// @author ハル研究所プログラミングコンテスト実行委員会
+///
+/// @copyright  Copyright (c) 2015 HAL Laboratory, Inc.
+/// @attention  このファイルの利用は、同梱のREADMEにある
+///             利用条件に従ってください
+
+//------------------------------------------------------------------------------
+
+#include "HPCDeadline.hpp"
+
+#include <chrono>
+#include "HPCTrace.hpp"
+
+namespace {
+
+    /// 監視スレッドが Timer を調べる間隔。時間切れの検出はこれだけ遅れることがあります。
+    const std::chrono::microseconds WatchInterval(500);
+}
+
+namespace hpc {
+
+    //------------------------------------------------------------------------------
+    /// クラスのインスタンスを生成します。
+    ///
+    /// @note 生成しただけでは監視を行いません。
+    ///       監視を行うには、aTimer を開始した後で start 関数を呼び出します。
+    ///
+    /// @param[in] aTimer 監視するタイマー。このインスタンスより長く生存する必要があります。
+    Deadline::Deadline(const Timer& aTimer)
+        : mTimer(aTimer)
+        , mIsExpired(false)
+        , mIsStopRequested(false)
+        , mThread()
+    {
+    }
+
+    //------------------------------------------------------------------------------
+    /// インスタンスを破棄します。監視中なら終了を待ちます。
+    Deadline::~Deadline()
+    {
+        stop();
+    }
+
+    //------------------------------------------------------------------------------
+    /// 監視を開始します。
+    ///
+    /// 制限時間がなければスレッドは起動せず、isInTime は常に @c true を返します。
+    void Deadline::start()
+    {
+        stop();
+        mIsExpired.store(!mTimer.isInTime(), std::memory_order_relaxed);
+        mIsStopRequested.store(false, std::memory_order_relaxed);
+        if (mTimer.limitSec() != 0) {
+            mThread = std::thread(&Deadline::watch, this);
+        }
+    }
+
+    //------------------------------------------------------------------------------
+    /// 監視を終了します。isInTime は最後の判定結果を返し続けます。
+    void Deadline::stop()
+    {
+        if (mThread.joinable()) {
+            mIsStopRequested.store(true, std::memory_order_relaxed);
+            mThread.join();
+        }
+    }
+
+    //------------------------------------------------------------------------------
+    /// 時間切れになるか終了が要求されるまで、一定間隔で Timer を調べます。
+    ///
+    /// 判定は Timer::isInTime そのものなので、ステージの開始時に Timer を直接見たときと同じ時計で測ります。
+    void Deadline::watch()
+    {
+        Trace::SetThreadName("watchdog");
+        HPC_TRACE_SCOPE("watch", "deadline", 0);
+        while (!mIsStopRequested.load(std::memory_order_relaxed)) {
+            if (!mTimer.isInTime()) {
+                mIsExpired.store(true, std::memory_order_relaxed);
+                return;
+            }
+            std::this_thread::sleep_for(WatchInterval);
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+// EOF
@@ -0,0 +1,64 @@
+//------------------------------------------------------------------------------
+/// @file
+/// @brief Deadline クラス
+/// @author ハル研究所プログラミングコンテスト実行委員会
+///
+/// @copyright  Copyright (c) 2015 HAL Laboratory, Inc.
+/// @attention  このファイルの利用は、同梱のREADMEにある
+///             利用条件に従ってください
+
+//------------------------------------------------------------------------------
+#pragma once
+
+#include <atomic>
+#include <thread>
+#include "HPCTimer.hpp"
+
+namespace hpc {
+
+    //------------------------------------------------------------------------------
+    /// ターンごとに呼んでも安い、制限時間の判定を提供します。
+    ///
+    /// 監視スレッドが一定間隔で Timer を調べ、制限時間を過ぎたらフラグを立てます。
+    /// isInTime はフラグを読むだけなので、時計を読むことはありません。
+    /// フラグは Timer が時間切れと判定した後にしか立たないため、早く時間切れになることはなく、
+    /// 遅れは監視の間隔までです。ステージの開始時など正確さが要る所では Timer を直接使います。
+    /// TimerMode_ProcessCpu では監視スレッド自身の CPU 時間も数えられるので、
+    /// Simulation は制限時間があるときの既定を TimerMode_ThreadCpu にしています。
+    ///
+    /// Timer に制限時間がない場合は、監視スレッドを起動しません。
+    class Deadline
+    {
+    public:
+        Deadline(const Timer& aTimer);
+        ~Deadline();
+
+        void start();                       ///< 監視を開始します。
+        void stop();                        ///< 監視を終了します。
+        bool isInTime()const;              ///< 制限時間内かどうかを返します。
+
+    private:
+        Deadline(const Deadline&);
+        Deadline& operator=(const Deadline&);
+
+        void watch();                       ///< 監視スレッドの本体です。
+
+        const Timer& mTimer;                ///< 監視するタイマー
+        std::atomic<bool> mIsExpired;       ///< 制限時間を過ぎたか
+        std::atomic<bool> mIsStopRequested; ///< 監視の終了が要求されたか
+        std::thread mThread;                ///< 監視スレッド
+    };
+
+    //------------------------------------------------------------------------------
+    /// 制限時間内かどうかを返します。
+    ///
+    /// 毎ターン呼ばれるので、フラグを読むだけにしています。
+    ///
+    /// @return 監視スレッドが時間切れを検出していなければ @c true 。
+    inline bool Deadline::isInTime()const
+    {
+        return !mIsExpired.load(std::memory_order_relaxed);
+    }
+}
+//------------------------------------------------------------------------------
+// EOF
@@ -13,6 +13,10 @@
 
 #include "HPCCommon.hpp"
 #include "HPCLevelDesigner.hpp"
+#include "HPCMemory.hpp"
+#include "HPCPerfCounter.hpp"
+#include "HPCProfiler.hpp"
+#include "HPCTrace.hpp"
 
 namespace hpc {
 
@@ -24,24 +28,61 @@ namespace hpc {
         : mRandom(aRandom)
         , mStage()
         , mCurrentStageIndex(0)
+        , mTimerMode(TimerMode_ProcessCpu)
         , mRecord()
+        , mScheduler()
+        , mMetrics()
     {
     }
 
+    //------------------------------------------------------------------------------
+    /// 制限時間の計測方法を設定します。ステージを開始するたびに Stage へ渡します。
+    ///
+    /// @param[in] aMode ゲームの制限時間の計測方法。
+    void Game::setTimerMode(TimerMode aMode)
+    {
+        mTimerMode = aMode;
+    }
+
     //------------------------------------------------------------------------------
     /// 現在指定されているステージを開始します。
     ///
     /// @pre 現在のステージ番号が有効な範囲内にある必要があります。
-    void Game::startStage(bool aIsInTime)
+    ///
+    /// @param[in] aIsInTime 制限時間内かどうか。
+    /// @param[in] aRestSec  ゲーム全体の残り時間[秒]。0 以下なら制限なし。
+    void Game::startStage(bool aIsInTime, double aRestSec)
     {
         HPC_ASSERT_MSG(isValidStage(), "Index indicates an invalid Stage (#%d)", mCurrentStageIndex);
 
         // ステージの生成を行います。
-        LevelDesigner::Setup(mCurrentStageIndex, mStage, mRandom);
+        HPC_PROFILE_SET_STAGE(mCurrentStageIndex);
+        {
+            HPC_PROFILE_SCOPE(ProfilePhase_Setup);
+            HPC_TRACE_SCOPE("generate", "stage", mCurrentStageIndex);
+            LevelDesigner::Setup(mCurrentStageIndex, mStage, mRandom);
+        }
+
+        // 残り時間から、このステージの解答が使える時間を割り振ります。
+        mStage.setSolveTimeLimitSec(mScheduler.stageBudgetSec(mCurrentStageIndex, mStage, aRestSec));
+        mStage.setTimerMode(mTimerMode);
 
-        mStage.start(aIsInTime);
-        mRecord.writeStartStage(mCurrentStageIndex, mStage);
-        mRecord.writeTurn(mStage.lastTurnResult());
+        {
+            HPC_TRACE_SCOPE("solve", "stage", mCurrentStageIndex);
+            HPC_PERF_SCOPE(PerfPhase_Init, mCurrentStageIndex);
+            HPC_MEMORY_TAG_SCOPE(MemoryTag_Solver);
+            mStage.start(aIsInTime);
+        }
+        if (mCurrentStageIndex == 0) {
+            Memory::Snapshot("first stage solved");
+        }
+        mPlanAnalyzer.startStage(mStage);
+        {
+            HPC_PROFILE_SCOPE(ProfilePhase_RecordWrite);
+            HPC_TRACE_SCOPE("record", "stage", mCurrentStageIndex);
+            mRecord.writeStartStage(mCurrentStageIndex, mStage);
+            mRecord.writeTurn(mStage.lastTurnResult());
+        }
     }
 
     //------------------------------------------------------------------------------
@@ -52,8 +93,17 @@ namespace hpc {
     {
         HPC_ASSERT_MSG(isValidStage(), "Index indicates an invalid Stage (#%d)", mCurrentStageIndex);
 
-        mStage.runTurn();
-        mRecord.writeTurn(mStage.lastTurnResult());
+        {
+            HPC_PROFILE_SCOPE(ProfilePhase_RunTurn);
+            HPC_PERF_SCOPE(PerfPhase_RunTurn, mCurrentStageIndex);
+            HPC_MEMORY_TAG_SCOPE(MemoryTag_Solver);
+            mStage.runTurn();
+        }
+        mPlanAnalyzer.addTurn(mStage, mStage.lastTurnResult());
+        {
+            HPC_PROFILE_SCOPE(ProfilePhase_RecordWrite);
+            mRecord.writeTurn(mStage.lastTurnResult());
+        }
     }
 
     //------------------------------------------------------------------------------
@@ -75,7 +125,15 @@ namespace hpc {
     void Game::onStageDone()
     {
         HPC_ASSERT_MSG(isValidStage(), "Index indicates an invalid Stage (#%d)", mCurrentStageIndex);
-        mRecord.writeEndStage(mStage);
+        {
+            HPC_PROFILE_SCOPE(ProfilePhase_RecordWrite);
+            HPC_TRACE_SCOPE("record", "stage", mCurrentStageIndex);
+            mRecord.writeEndStage(mStage);
+            mMetrics.writeStage(mCurrentStageIndex, mStage);
+        }
+        mPlanAnalyzer.endStage(mCurrentStageIndex, mStage);
+        mLowerBound.addStage(mCurrentStageIndex, mStage);
+        mLatencyReport.addStage(mCurrentStageIndex, mStage);
         ++mCurrentStageIndex;
     }
 
@@ -92,6 +150,15 @@ namespace hpc {
         return (0 <= mCurrentStageIndex && mCurrentStageIndex < Parameter::GameStageCount);
     }
 
+    //------------------------------------------------------------------------------
+    /// 現在のステージ番号を返します。
+    ///
+    /// @return ステージ番号。すべてのステージを終えた後は Parameter::GameStageCount 。
+    int Game::currentStageIndex()const
+    {
+        return mCurrentStageIndex;
+    }
+
     //------------------------------------------------------------------------------
     /// 内部に格納されているゲームの記録を返します。
     ///
@@ -100,6 +167,77 @@ namespace hpc {
     {
         return mRecord;
     }
+
+    //------------------------------------------------------------------------------
+    /// ステージごとの指標の出力先を返します。
+    ///
+    /// 開いておくと、ステージが終わるたびに指標が書き出されます。
+    ///
+    /// @return 指標を出力する @c Metrics クラスへの参照を返します。
+    Metrics& Game::metrics()
+    {
+        return mMetrics;
+    }
+
+    //------------------------------------------------------------------------------
+    /// 実行された計画の分析を返します。
+    ///
+    /// 有効にしておくと、ターンごとに壁への衝突や遠回りが数えられます。
+    ///
+    /// @return 計画を分析する @c PlanAnalyzer クラスへの参照を返します。
+    PlanAnalyzer& Game::planAnalyzer()
+    {
+        return mPlanAnalyzer;
+    }
+
+    //------------------------------------------------------------------------------
+    /// 実行された計画の分析を返します。
+    ///
+    /// @return 計画を分析する @c PlanAnalyzer クラスへの const 参照を返します。
+    const PlanAnalyzer& Game::planAnalyzer()const
+    {
+        return mPlanAnalyzer;
+    }
+
+    //------------------------------------------------------------------------------
+    /// 燃料の下界と最適性ギャップの集計を返します。
+    ///
+    /// 有効にしておくと、ステージが終わるたびに下界を求めるための問題が控えられます。
+    ///
+    /// @return 下界を求める @c LowerBound クラスへの参照を返します。
+    LowerBound& Game::lowerBound()
+    {
+        return mLowerBound;
+    }
+
+    //------------------------------------------------------------------------------
+    /// 燃料の下界と最適性ギャップの集計を返します。
+    ///
+    /// @return 下界を求める @c LowerBound クラスへの const 参照を返します。
+    const LowerBound& Game::lowerBound()const
+    {
+        return mLowerBound;
+    }
+
+    //------------------------------------------------------------------------------
+    /// 解答の待ち時間の集計を返します。
+    ///
+    /// 有効にしておくと、ステージが終わるたびに Answer::Init と Answer::InitPeriod の時間が記録されます。
+    ///
+    /// @return 待ち時間を集計する @c LatencyReport クラスへの参照を返します。
+    LatencyReport& Game::latencyReport()
+    {
+        return mLatencyReport;
+    }
+
+    //------------------------------------------------------------------------------
+    /// 解答の待ち時間の集計を返します。
+    ///
+    /// @return 待ち時間を集計する @c LatencyReport クラスへの const 参照を返します。
+    const LatencyReport& Game::latencyReport()const
+    {
+        return mLatencyReport;
+    }
 }
 
 //------------------------------------------------------------------------------
@@ -14,6 +14,11 @@
 #include "HPCRandom.hpp"
 #include "HPCRecord.hpp"
 #include "HPCStage.hpp"
+#include "HPCStageScheduler.hpp"
+#include "HPCLatencyReport.hpp"
+#include "HPCLowerBound.hpp"
+#include "HPCMetrics.hpp"
+#include "HPCPlanAnalyzer.hpp"
 
 namespace hpc {
 
@@ -24,19 +29,34 @@ namespace hpc {
     public:
         Game(Random& aRandom);
 
-        void startStage(bool aIsInTime);   ///< 現在のステージを開始します。
+        void setTimerMode(TimerMode aMode); ///< 制限時間の計測方法を設定します。
+        void startStage(bool aIsInTime, double aRestSec); ///< 現在のステージを開始します。
         void runTurn();                     ///< 現在実行中のステージでターンを1つ進めます。
         StageState state()const;           ///< ステージ内での現在の状態を表します。
         void onStageDone();                 ///< ステージ終了を通知します。
         bool isValidStage()const;          ///< 現在のステージが有効なものかどうかを返します。
+        int currentStageIndex()const;      ///< 現在のステージ番号を返します。
 
         const Record& record()const;       ///< 記録へのアクセサ
+        Metrics& metrics();                 ///< 指標の出力へのアクセサ
+        PlanAnalyzer& planAnalyzer();       ///< 計画の分析へのアクセサ
+        const PlanAnalyzer& planAnalyzer()const; ///< 計画の分析へのアクセサ
+        LowerBound& lowerBound();           ///< 燃料の下界へのアクセサ
+        const LowerBound& lowerBound()const; ///< 燃料の下界へのアクセサ
+        LatencyReport& latencyReport();     ///< 解答の待ち時間の集計へのアクセサ
+        const LatencyReport& latencyReport()const; ///< 解答の待ち時間の集計へのアクセサ
 
     private:
         Random& mRandom;                    ///< 乱数生成
         Stage mStage;                       ///< ステージ
         int mCurrentStageIndex;             ///< 現在のステージ番号
+        TimerMode mTimerMode;               ///< 制限時間の計測方法
         Record mRecord;                     ///< 記録
+        StageScheduler mScheduler;          ///< 制限時間の割り振り
+        Metrics mMetrics;                   ///< ステージごとの指標の出力
+        PlanAnalyzer mPlanAnalyzer;         ///< 実行された計画の分析
+        LowerBound mLowerBound;             ///< 燃料の下界と最適性ギャップ
+        LatencyReport mLatencyReport;       ///< 解答の待ち時間の分布
     };
 }
 //------------------------------------------------------------------------------
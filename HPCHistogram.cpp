@@ -0,0 +1,157 @@
+//------------------------------------------------------------------------------
+/// @file
+/// @brief HPCHistogram.hpp の実装
+/// @author ハル研究所プログラミングコンテスト実行委員会
+///
+/// @copyright  Copyright (c) 2015 HAL Laboratory, Inc.
+/// @attention  このファイルの利用は、同梱のREADMEにある
+///             利用条件に従ってください
+
+//------------------------------------------------------------------------------
+
+#include "HPCHistogram.hpp"
+
+#include "HPCCommon.hpp"
+
+namespace hpc {
+
+    //------------------------------------------------------------------------------
+    /// 空のヒストグラムを生成します。
+    Histogram::Histogram()
+    {
+        clear();
+    }
+
+    //------------------------------------------------------------------------------
+    /// 記録を消去します。
+    void Histogram::clear()
+    {
+        for (int i = 0; i < BucketCount; ++i) {
+            mCounts[i] = 0;
+        }
+        mCount = 0;
+        mSum = 0;
+        mMax = 0;
+    }
+
+    //------------------------------------------------------------------------------
+    /// 値を 1 つ記録します。
+    ///
+    /// @param[in] aValue 記録する値。負の値は 0 として扱います。
+    void Histogram::add(int64_t aValue)
+    {
+        if (aValue < 0) {
+            aValue = 0;
+        }
+        ++mCounts[BucketIndex(aValue)];
+        ++mCount;
+        mSum += aValue;
+        if (mMax < aValue) {
+            mMax = aValue;
+        }
+    }
+
+    //------------------------------------------------------------------------------
+    /// 別のヒストグラムの記録を足し込みます。
+    ///
+    /// @param[in] aOther 足し込むヒストグラム。
+    void Histogram::merge(const Histogram& aOther)
+    {
+        for (int i = 0; i < BucketCount; ++i) {
+            mCounts[i] += aOther.mCounts[i];
+        }
+        mCount += aOther.mCount;
+        mSum += aOther.mSum;
+        if (mMax < aOther.mMax) {
+            mMax = aOther.mMax;
+        }
+    }
+
+    //------------------------------------------------------------------------------
+    /// @return 記録した値の個数。
+    int64_t Histogram::count()const
+    {
+        return mCount;
+    }
+
+    //------------------------------------------------------------------------------
+    /// @return 記録した値の合計。
+    int64_t Histogram::sum()const
+    {
+        return mSum;
+    }
+
+    //------------------------------------------------------------------------------
+    /// @return 記録した値の最大値。記録がなければ 0 。
+    int64_t Histogram::max()const
+    {
+        return mMax;
+    }
+
+    //------------------------------------------------------------------------------
+    /// 分位点を返します。
+    ///
+    /// @param[in] aPercent 0 ～ 100 で指定する割合。50 なら中央値です。
+    ///
+    /// @return 記録した値の aPercent [%] がそれ以下となる値の近似値。最大値は超えません。記録がなければ 0 。
+    int64_t Histogram::percentile(double aPercent)const
+    {
+        HPC_ASSERT(0.0 <= aPercent && aPercent <= 100.0);
+        if (mCount == 0) {
+            return 0;
+        }
+        int64_t rank = static_cast<int64_t>(aPercent / 100.0 * mCount + 0.5);
+        if (rank < 1) {
+            rank = 1;
+        }
+        int64_t seen = 0;
+        for (int i = 0; i < BucketCount; ++i) {
+            seen += mCounts[i];
+            if (seen >= rank) {
+                const int64_t value = BucketValue(i);
+                return value < mMax ? value : mMax;
+            }
+        }
+        return mMax;
+    }
+
+    //------------------------------------------------------------------------------
+    /// 値の入る区間を返します。
+    ///
+    /// 最上位ビットの位置と、その下 SubBucketBits ビットで区間を決めます。
+    ///
+    /// @param[in] aValue 0 以上の値。
+    ///
+    /// @return 区間の番号。
+    int Histogram::BucketIndex(int64_t aValue)
+    {
+        if (aValue < SubBucketCount) {
+            return static_cast<int>(aValue);
+        }
+        int topBit = 0;
+        while ((aValue >> (topBit + 1)) != 0) {
+            ++topBit;
+        }
+        const int sub = static_cast<int>((aValue >> (topBit - SubBucketBits)) & (SubBucketCount - 1));
+        return (topBit - SubBucketBits + 1) * SubBucketCount + sub;
+    }
+
+    //------------------------------------------------------------------------------
+    /// 区間を代表する値(区間の上端)を返します。
+    ///
+    /// @param[in] aIndex 区間の番号。
+    ///
+    /// @return 区間に入る値の最大値。
+    int64_t Histogram::BucketValue(int aIndex)
+    {
+        if (aIndex < SubBucketCount) {
+            return aIndex;
+        }
+        const int topBit = aIndex / SubBucketCount - 1 + SubBucketBits;
+        const int64_t sub = aIndex % SubBucketCount;
+        const int64_t lower = (static_cast<int64_t>(1) << topBit) | (sub << (topBit - SubBucketBits));
+        return lower + (static_cast<int64_t>(1) << (topBit - SubBucketBits)) - 1;
+    }
+}
+//------------------------------------------------------------------------------
+// EOF
@@ -0,0 +1,51 @@
+//------------------------------------------------------------------------------
+/// @file
+/// @brief Histogram クラス
+/// @author ハル研究所プログラミングコンテスト実行委員会
+///
+/// @copyright  Copyright (c) 2015 HAL Laboratory, Inc.
+/// @attention  このファイルの利用は、同梱のREADMEにある
+///             利用条件に従ってください
+
+//------------------------------------------------------------------------------
+#pragma once
+
+#include <cstdint>
+
+namespace hpc {
+
+    //------------------------------------------------------------------------------
+    /// 0 以上の整数値(主に時間[ナノ秒])の分布を、対数の区間で数えます。
+    ///
+    /// 2 の冪ごとの区間をさらに SubBucketCount 個に分けるので、
+    /// 分位点の誤差は値の 1 / SubBucketCount 程度に収まります。最大値と合計は正確に保持します。
+    class Histogram
+    {
+    public:
+        Histogram();
+
+        void clear();                                   ///< 記録を消去します。
+        void add(int64_t aValue);                       ///< 値を 1 つ記録します。
+        void merge(const Histogram& aOther);            ///< 別のヒストグラムの記録を足し込みます。
+
+        int64_t count()const;                           ///< 記録した値の個数を返します。
+        int64_t sum()const;                             ///< 記録した値の合計を返します。
+        int64_t max()const;                             ///< 記録した値の最大値を返します。
+        int64_t percentile(double aPercent)const;       ///< 分位点を返します。
+
+    private:
+        static const int SubBucketBits = 4;             ///< 2 の冪ごとの区間を分けるビット数
+        static const int SubBucketCount = 1 << SubBucketBits;
+        static const int BucketCount = 64 * SubBucketCount;
+
+        static int BucketIndex(int64_t aValue);         ///< 値の入る区間を返します。
+        static int64_t BucketValue(int aIndex);         ///< 区間を代表する値を返します。
+
+        int64_t mCounts[BucketCount];                   ///< 区間ごとの個数
+        int64_t mCount;                                 ///< 個数
+        int64_t mSum;                                   ///< 合計
+        int64_t mMax;                                   ///< 最大値
+    };
+}
+//------------------------------------------------------------------------------
+// EOF
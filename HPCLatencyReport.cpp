@@ -0,0 +1,133 @@
+//------------------------------------------------------------------------------
+/// @file
+/// @brief HPCLatencyReport.hpp の実装
+/// @author ハル研究所プログラミングコンテスト実行委員会
+///
+/// @copyright  Copyright (c) 2015 HAL Laboratory, Inc.
+/// @attention  このファイルの利用は、同梱のREADMEにある
+///             利用条件に従ってください
+
+//------------------------------------------------------------------------------
+
+#include "HPCLatencyReport.hpp"
+
+#include <cstdio>
+#include "HPCCommon.hpp"
+#include "HPCStage.hpp"
+
+namespace {
+    using namespace hpc;
+
+    //------------------------------------------------------------------------------
+    /// 1 行分の分位点を表示します。
+    ///
+    /// @param[in] aLabel     行の見出し。
+    /// @param[in] aHistogram 表示するヒストグラム。
+    void PrintRow(const char* aLabel, const Histogram& aHistogram)
+    {
+        HPC_PRINT("%-12s %6lld %10.3f %10.3f %10.3f %10.3f %10.3f\n", aLabel,
+            static_cast<long long>(aHistogram.count()),
+            aHistogram.percentile(50) / 1e6,
+            aHistogram.percentile(90) / 1e6,
+            aHistogram.percentile(99) / 1e6,
+            aHistogram.percentile(99.9) / 1e6,
+            aHistogram.max() / 1e6);
+    }
+}
+
+namespace hpc {
+
+    const double LatencyReport::SloPercentile = 99.0;
+
+    //------------------------------------------------------------------------------
+    /// LatencyReport クラスのインスタンスを生成します。
+    LatencyReport::LatencyReport()
+        : mIsEnabled(false)
+        , mSloNanoSec(0)
+        , mOverSloCount(0)
+        , mWorstStageIndex(-1)
+        , mOverall()
+        , mItemBuckets()
+    {
+    }
+
+    //------------------------------------------------------------------------------
+    /// 集計を有効にします。ステージを始める前に呼んでください。
+    void LatencyReport::enable()
+    {
+        mIsEnabled = true;
+    }
+
+    //------------------------------------------------------------------------------
+    /// @return enable を呼んでいれば @c true 。
+    bool LatencyReport::isEnabled()const
+    {
+        return mIsEnabled;
+    }
+
+    //------------------------------------------------------------------------------
+    /// 待ち時間の目標を設定し、集計を有効にします。
+    ///
+    /// @param[in] aMilliSec 全体の SloPercentile 分位点の上限[ミリ秒]。
+    void LatencyReport::setSlo(double aMilliSec)
+    {
+        HPC_ASSERT(aMilliSec > 0.0);
+        mSloNanoSec = static_cast<int64_t>(aMilliSec * 1e6);
+        enable();
+    }
+
+    //------------------------------------------------------------------------------
+    /// 終了したステージの待ち時間を記録します。
+    ///
+    /// @param[in] aStageIndex ステージ番号。
+    /// @param[in] aStage      終了したステージ。
+    void LatencyReport::addStage(int aStageIndex, const Stage& aStage)
+    {
+        if (!mIsEnabled) {
+            return;
+        }
+        const int64_t latency = static_cast<int64_t>((aStage.solveSec() + aStage.initPeriodSec()) * 1e9);
+        if (latency > mOverall.max()) {
+            mWorstStageIndex = aStageIndex;
+        }
+        mOverall.add(latency);
+        mItemBuckets[LevelDesigner::ItemCountIndex(aStageIndex) / LevelDesigner::CategoryItemStep].add(latency);
+        if (mSloNanoSec != 0 && latency > mSloNanoSec) {
+            ++mOverSloCount;
+        }
+    }
+
+    //------------------------------------------------------------------------------
+    /// @return 目標を設定していて、全体の SloPercentile 分位点が目標を超えていれば @c true 。
+    bool LatencyReport::isSloBreached()const
+    {
+        return mIsEnabled && mSloNanoSec != 0 && mOverall.percentile(SloPercentile) > mSloNanoSec;
+    }
+
+    //------------------------------------------------------------------------------
+    /// 全体と荷物数の区分ごとに、待ち時間の分位点[ミリ秒]を表示します。目標を設定していれば判定も表示します。
+    void LatencyReport::print()const
+    {
+        if (!mIsEnabled) {
+            return;
+        }
+        HPC_PRINT("Solve latency [ms] (Answer::Init + Answer::InitPeriod per stage)\n");
+        HPC_PRINT("%-12s %6s %10s %10s %10s %10s %10s\n", "Items", "Stages", "p50", "p90", "p99", "p99.9", "max");
+        PrintRow("all", mOverall);
+        for (int i = 0; i < ItemBucketCount; ++i) {
+            char label[16];
+            std::snprintf(label, sizeof(label), "%2d-%2d", i * LevelDesigner::CategoryItemStep + 1, (i + 1) * LevelDesigner::CategoryItemStep);
+            PrintRow(label, mItemBuckets[i]);
+        }
+        if (mWorstStageIndex >= 0) {
+            HPC_PRINT("Slowest stage: %d\n", mWorstStageIndex);
+        }
+        if (mSloNanoSec != 0) {
+            HPC_PRINT("SLO p%g <= %.3f ms: %s (p%g = %.3f ms, %d stages over)\n",
+                SloPercentile, mSloNanoSec / 1e6, isSloBreached() ? "BREACHED" : "met",
+                SloPercentile, mOverall.percentile(SloPercentile) / 1e6, mOverSloCount);
+        }
+    }
+}
+//------------------------------------------------------------------------------
+// EOF
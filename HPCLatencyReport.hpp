@@ -0,0 +1,51 @@
+//------------------------------------------------------------------------------
+/// @file
+/// @brief LatencyReport クラス
+/// @author ハル研究所プログラミングコンテスト実行委員会
+///
+/// @copyright  Copyright (c) 2015 HAL Laboratory, Inc.
+/// @attention  このファイルの利用は、同梱のREADMEにある
+///             利用条件に従ってください
+
+//------------------------------------------------------------------------------
+#pragma once
+
+#include "HPCHistogram.hpp"
+#include "HPCLevelDesigner.hpp"
+#include "HPCParameter.hpp"
+
+namespace hpc {
+    class Stage;
+
+    //------------------------------------------------------------------------------
+    /// ステージごとの解答の待ち時間(Answer::Init と全ての Answer::InitPeriod の合計)の分布を集計します。
+    ///
+    /// 全体と荷物数の区分(LevelDesigner::CategoryItemStep 個ごと)について分位点を表示します。
+    /// 目標(SLO)を設定すると、全体の SloPercentile 分位点が目標を超えたかどうかを判定します。
+    class LatencyReport
+    {
+    public:
+        LatencyReport();
+
+        void enable();                                      ///< 集計を有効にします。
+        bool isEnabled()const;                             ///< 集計が有効かどうかを返します。
+        void setSlo(double aMilliSec);                      ///< 待ち時間の目標を設定します。
+        void addStage(int aStageIndex, const Stage& aStage); ///< 終了したステージの待ち時間を記録します。
+        bool isSloBreached()const;                         ///< 目標を超えたかどうかを返します。
+        void print()const;                                 ///< 集計結果を表示します。
+
+        static const double SloPercentile;                  ///< 目標と比べる分位点[%]
+
+    private:
+        static const int ItemBucketCount = Parameter::ItemCountMax / LevelDesigner::CategoryItemStep; ///< 荷物数の区分の数
+
+        bool mIsEnabled;                                    ///< 集計するか
+        int64_t mSloNanoSec;                                ///< 目標[ナノ秒]。0 なら目標なし
+        int mOverSloCount;                                  ///< 待ち時間が目標を超えたステージ数
+        int mWorstStageIndex;                               ///< 待ち時間が最も長かったステージ
+        Histogram mOverall;                                 ///< 全体の分布
+        Histogram mItemBuckets[ItemBucketCount];            ///< 荷物数の区分ごとの分布
+    };
+}
+//------------------------------------------------------------------------------
+// EOF
@@ -11,6 +11,7 @@
 
 #include "HPCLevelDesigner.hpp"
 
+#include <cstdio>
 #include <cstdlib>
 #include "HPCCommon.hpp"
 #include "HPCMath.hpp"
@@ -32,9 +33,9 @@ namespace hpc {
         height += aRandom.randTerm((Parameter::FieldHeightMax - Parameter::FieldHeightMin) / 4 + 1) * 4;
 
         // ステージ番号から、壁密度、時間帯指定されている荷物の割合、荷物数を決める。
-        int wallDensityIndex = aNumber % Parameter::WallDensityMax;
-        int periodSpecifiedIndex = (aNumber / Parameter::WallDensityMax) % Parameter::PeriodSpecifiedMax;
-        int itemCountIndex = (aNumber / (Parameter::WallDensityMax * Parameter::PeriodSpecifiedMax)) % Parameter::ItemCountMax;
+        int wallDensityIndex = WallDensityIndex(aNumber);
+        int periodSpecifiedIndex = PeriodSpecifiedIndex(aNumber);
+        int itemCountIndex = ItemCountIndex(aNumber);
 
         // wallDensity は 0 にはならないようにする。あまりにも壁がない迷路になるため。
         int wallDensity = (wallDensityIndex + 1) * (100 / Parameter::WallDensityMax);
@@ -105,6 +106,70 @@ namespace hpc {
             aStage.items().addItem(pos, periodSpecs[i], itemWeights[i]);
         }
     }
+
+    //------------------------------------------------------------------------------
+    /// ステージ番号から、壁密度の段階を返します。
+    ///
+    /// @param[in] aNumber ステージ番号
+    ///
+    /// @return [0, Parameter::WallDensityMax) の値。
+    int LevelDesigner::WallDensityIndex(int aNumber)
+    {
+        return aNumber % Parameter::WallDensityMax;
+    }
+
+    //------------------------------------------------------------------------------
+    /// ステージ番号から、時間帯指定されている荷物の割合の段階を返します。
+    ///
+    /// @param[in] aNumber ステージ番号
+    ///
+    /// @return [0, Parameter::PeriodSpecifiedMax) の値。
+    int LevelDesigner::PeriodSpecifiedIndex(int aNumber)
+    {
+        return (aNumber / Parameter::WallDensityMax) % Parameter::PeriodSpecifiedMax;
+    }
+
+    //------------------------------------------------------------------------------
+    /// ステージ番号から、荷物数の段階を返します。
+    ///
+    /// @param[in] aNumber ステージ番号
+    ///
+    /// @return [0, Parameter::ItemCountMax) の値。荷物数はこれに 1 を足したものです。
+    int LevelDesigner::ItemCountIndex(int aNumber)
+    {
+        return (aNumber / (Parameter::WallDensityMax * Parameter::PeriodSpecifiedMax)) % Parameter::ItemCountMax;
+    }
+
+    //------------------------------------------------------------------------------
+    /// ステージ番号から、集計用のステージの種類を返します。
+    ///
+    /// 壁密度の段階と、荷物数を CategoryItemStep 個ごとに区切ったものの組です。
+    /// 計測結果をステージの性質ごとに分けて見るために使います。
+    ///
+    /// @param[in] aNumber ステージ番号
+    ///
+    /// @return [0, CategoryCount) の値。
+    int LevelDesigner::Category(int aNumber)
+    {
+        return WallDensityIndex(aNumber) * (Parameter::ItemCountMax / CategoryItemStep) + ItemCountIndex(aNumber) / CategoryItemStep;
+    }
+
+    //------------------------------------------------------------------------------
+    /// ステージの種類を表す文字列を返します。
+    ///
+    /// @param[in] aCategory ステージの種類。
+    ///
+    /// @return "wall 1 items  1- 4" の形式の文字列。次に呼ぶまで有効です。
+    const char* LevelDesigner::CategoryLabel(int aCategory)
+    {
+        HPC_RANGE_ASSERT_MIN_UB_I(aCategory, 0, CategoryCount);
+        static char label[32];
+        const int itemCategory = aCategory % (Parameter::ItemCountMax / CategoryItemStep);
+        std::snprintf(label, sizeof(label), "wall %d items %2d-%2d",
+            aCategory / (Parameter::ItemCountMax / CategoryItemStep) + 1,
+            itemCategory * CategoryItemStep + 1, (itemCategory + 1) * CategoryItemStep);
+        return label;
+    }
 }
 
 //------------------------------------------------------------------------------
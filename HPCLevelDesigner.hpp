@@ -23,6 +23,22 @@ namespace hpc {
         /// ステージのマップを生成します。
         static void Setup(int aNumber, Stage& aStage, Random& aRandom);
 
+        /// ステージ番号から、壁密度の段階を返します。
+        static int WallDensityIndex(int aNumber);
+        /// ステージ番号から、時間帯指定されている荷物の割合の段階を返します。
+        static int PeriodSpecifiedIndex(int aNumber);
+        /// ステージ番号から、荷物数の段階(荷物数 - 1)を返します。
+        static int ItemCountIndex(int aNumber);
+
+        /// 集計用のステージの種類の数。壁密度の段階数 × 荷物数の区分数です。
+        static const int CategoryItemStep = 4;
+        static const int CategoryCount = Parameter::WallDensityMax * (Parameter::ItemCountMax / CategoryItemStep);
+
+        /// ステージ番号から、集計用のステージの種類を返します。
+        static int Category(int aNumber);
+        /// ステージの種類を表す文字列を返します。
+        static const char* CategoryLabel(int aCategory);
+
     private:
         LevelDesigner();
     };
@@ -0,0 +1,355 @@
+//------------------------------------------------------------------------------
+/// @file
+/// @brief HPCLowerBound.hpp の実装
+/// @author ハル研究所プログラミングコンテスト実行委員会
+///
+/// @copyright  Copyright (c) 2015 HAL Laboratory, Inc.
+/// @attention  このファイルの利用は、同梱のREADMEにある
+///             利用条件に従ってください
+
+//------------------------------------------------------------------------------
+
+#include "HPCLowerBound.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include "HPCCommon.hpp"
+#include "HPCLevelDesigner.hpp"
+#include "HPCPlanAnalyzer.hpp"
+#include "HPCStage.hpp"
+
+namespace {
+    using namespace hpc;
+
+    /// 営業所の地点番号。
+    const int OfficePoint = Parameter::ItemCountMax;
+
+    /// 解がないことを表す燃料。足しても溢れない大きさにしておく。
+    const int InfeasibleFuel = std::numeric_limits<int>::max() / 4;
+
+    /// ステージの種類ごとの集計
+    struct Rollup {
+        int stageCount;         ///< ステージ数
+        int completeCount;      ///< 配達を完了したステージ数
+        int exactCount;         ///< 下界が最適値だったステージ数
+        int64_t fuel;           ///< 完了したステージの燃料の合計
+        int64_t bound;          ///< 完了したステージの下界の合計
+        int64_t score;          ///< 得点の合計
+        int64_t scoreBound;     ///< 下界の燃料で完了したときの得点の合計
+    };
+
+    //------------------------------------------------------------------------------
+    /// @return 立っているビットの数。
+    int BitCount(int aBits)
+    {
+        int count = 0;
+        for (; aBits != 0; aBits &= aBits - 1) {
+            ++count;
+        }
+        return count;
+    }
+
+    //------------------------------------------------------------------------------
+    /// @return ギャップ[%]。下界が 0 なら 0 。
+    double GapPercent(int64_t aFuel, int64_t aBound)
+    {
+        return aBound == 0 ? 0.0 : 100.0 * (aFuel - aBound) / aBound;
+    }
+
+    //------------------------------------------------------------------------------
+    /// @return 燃料 aFuel で完了したときの得点。 Stage::score と同じ式。
+    int Score(int aArea, int aItemCount, int aFuel)
+    {
+        return aFuel == 0 ? 0 : aArea * aItemCount * 10000 / aFuel;
+    }
+
+    //------------------------------------------------------------------------------
+    /// 営業所と配達先の最小全域木の重みを Prim 法で求めます。
+    int MinimumSpanningTree(const LowerBound::Problem& aProblem)
+    {
+        const int n = aProblem.itemCount;
+        int nearest[Parameter::ItemCountMax];
+        bool isInTree[Parameter::ItemCountMax] = {};
+        for (int i = 0; i < n; ++i) {
+            nearest[i] = aProblem.distance[OfficePoint][i];
+        }
+        int weight = 0;
+        for (int added = 0; added < n; ++added) {
+            int next = -1;
+            for (int i = 0; i < n; ++i) {
+                if (!isInTree[i] && (next == -1 || nearest[i] < nearest[next])) {
+                    next = i;
+                }
+            }
+            isInTree[next] = true;
+            weight += nearest[next];
+            for (int i = 0; i < n; ++i) {
+                nearest[i] = std::min(nearest[i], aProblem.distance[next][i]);
+            }
+        }
+        return weight;
+    }
+}
+
+namespace hpc {
+
+    //------------------------------------------------------------------------------
+    /// LowerBound クラスのインスタンスを生成します。
+    LowerBound::LowerBound()
+        : mIsEnabled(false)
+        , mEntries()
+    {
+    }
+
+    //------------------------------------------------------------------------------
+    /// 有効にします。ステージを始める前に呼んでください。
+    void LowerBound::enable()
+    {
+        mIsEnabled = true;
+        mEntries.reserve(Parameter::GameStageCount);
+    }
+
+    //------------------------------------------------------------------------------
+    /// @return enable を呼んでいれば @c true 。
+    bool LowerBound::isEnabled()const
+    {
+        return mIsEnabled;
+    }
+
+    //------------------------------------------------------------------------------
+    /// 終了したステージの問題と実際の燃料を控えます。
+    ///
+    /// @param[in] aStageIndex ステージ番号。 0 から順に呼んでください。
+    /// @param[in] aStage      終了したステージ。
+    void LowerBound::addStage(int aStageIndex, const Stage& aStage)
+    {
+        if (!mIsEnabled) {
+            return;
+        }
+        HPC_ASSERT(aStageIndex == static_cast<int>(mEntries.size()));
+        mEntries.push_back(Entry());
+        Entry& entry = mEntries.back();
+        BuildProblem(aStage, entry.problem);
+        entry.area = aStage.field().width() * aStage.field().height();
+        entry.fuel = aStage.totalCost();
+        entry.state = aStage.lastTurnResult().state;
+    }
+
+    //------------------------------------------------------------------------------
+    /// 控えたステージの下界を求め、ステージごととステージの種類ごとに表示します。
+    ///
+    /// Gap は完了したステージについての (実際の燃料 - 下界) / 下界 です。
+    /// 下界が最適値でないステージ(Exact が 0)では、本当のギャップはこれより小さくなります。
+    void LowerBound::print()const
+    {
+        if (!mIsEnabled) {
+            return;
+        }
+        Rollup rollups[LevelDesigner::CategoryCount + 1] = {};
+        Rollup& total = rollups[LevelDesigner::CategoryCount];
+        HPC_PRINT("%5s %-20s %5s %4s %8s %5s %8s %7s %8s %8s\n",
+            "Stage", "Category", "Items", "Free", "Bound", "Exact", "Fuel", "Gap%", "Score", "MaxScore");
+        for (int stageIndex = 0; stageIndex < static_cast<int>(mEntries.size()); ++stageIndex) {
+            const Entry& entry = mEntries[stageIndex];
+            const int itemCount = entry.problem.itemCount;
+            int freeCount = 0;
+            for (int i = 0; i < itemCount; ++i) {
+                if (entry.problem.period[i] < 0) {
+                    ++freeCount;
+                }
+            }
+            bool isExact = false;
+            const int bound = Compute(entry.problem, isExact);
+            const int category = LevelDesigner::Category(stageIndex);
+            const bool isComplete = entry.state == StageState_Complete;
+            const int score = isComplete ? Score(entry.area, itemCount, entry.fuel) : 0;
+            const int scoreBound = Score(entry.area, itemCount, bound);
+            if (isComplete) {
+                HPC_PRINT("%5d %-20s %5d %4d %8d %5d %8d %7.2f %8d %8d\n", stageIndex, LevelDesigner::CategoryLabel(category),
+                    itemCount, freeCount, bound, isExact ? 1 : 0, entry.fuel, GapPercent(entry.fuel, bound), score, scoreBound);
+            } else {
+                HPC_PRINT("%5d %-20s %5d %4d %8d %5d %8s %7s %8d %8d\n", stageIndex, LevelDesigner::CategoryLabel(category),
+                    itemCount, freeCount, bound, isExact ? 1 : 0, "-", "-", score, scoreBound);
+            }
+
+            Rollup* targets[] = { &rollups[category], &total };
+            for (int i = 0; i < 2; ++i) {
+                Rollup& rollup = *targets[i];
+                ++rollup.stageCount;
+                rollup.exactCount += isExact ? 1 : 0;
+                rollup.score += score;
+                rollup.scoreBound += scoreBound;
+                if (isComplete) {
+                    ++rollup.completeCount;
+                    rollup.fuel += entry.fuel;
+                    rollup.bound += bound;
+                }
+            }
+        }
+
+        HPC_PRINT("%-20s %6s %8s %5s %10s %10s %7s %10s %10s\n",
+            "Category", "Stages", "Complete", "Exact", "Bound", "Fuel", "Gap%", "Score", "MaxScore");
+        for (int category = 0; category <= LevelDesigner::CategoryCount; ++category) {
+            const Rollup& rollup = rollups[category];
+            if (rollup.stageCount == 0) {
+                continue;
+            }
+            HPC_PRINT("%-20s %6d %8d %5d %10lld %10lld %7.2f %10lld %10lld\n",
+                category == LevelDesigner::CategoryCount ? "total" : LevelDesigner::CategoryLabel(category),
+                rollup.stageCount, rollup.completeCount, rollup.exactCount,
+                static_cast<long long>(rollup.bound), static_cast<long long>(rollup.fuel), GapPercent(rollup.fuel, rollup.bound),
+                static_cast<long long>(rollup.score), static_cast<long long>(rollup.scoreBound));
+        }
+    }
+
+    //------------------------------------------------------------------------------
+    /// ステージから、荷物と地点間の最短距離の問題を作ります。
+    ///
+    /// @param[in]  aStage   対象のステージ。
+    /// @param[out] aProblem 作った問題。
+    void LowerBound::BuildProblem(const Stage& aStage, Problem& aProblem)
+    {
+        const Field& field = aStage.field();
+        const ItemCollection& items = aStage.items();
+        aProblem.itemCount = items.count();
+
+        Pos points[Parameter::ItemCountMax + 1];
+        for (int i = 0; i < items.count(); ++i) {
+            aProblem.weight[i] = items[i].weight();
+            aProblem.period[i] = items[i].period();
+            points[i] = items[i].destination();
+        }
+        points[OfficePoint] = field.officePos();
+
+        int distanceMap[Parameter::FieldHeightMax * Parameter::FieldWidthMax];
+        for (int to = 0; to <= OfficePoint; ++to) {
+            if (to >= items.count() && to != OfficePoint) {
+                continue;
+            }
+            PlanAnalyzer::ComputeDistanceMap(field, points[to], distanceMap);
+            for (int from = 0; from <= OfficePoint; ++from) {
+                if (from >= items.count() && from != OfficePoint) {
+                    continue;
+                }
+                const int distance = distanceMap[points[from].y * field.width() + points[from].x];
+                HPC_ASSERT(distance >= 0);
+                aProblem.distance[from][to] = distance;
+            }
+        }
+    }
+
+    //------------------------------------------------------------------------------
+    /// 燃料の下界を求めます。
+    ///
+    /// まず h(R, j) = 地点 j から荷物の集合 R を全て届けて営業所に戻るときの最小の燃料 を
+    /// 全ての R について求め、1 つの時間帯で集合 S を運ぶ最小の燃料 f(S) を得ます。
+    /// 時間帯指定のない荷物が少なければ、時間帯ごとに f を足す分け方を全て調べて最適値とします。
+    ///
+    /// @param[in]  aProblem 問題。
+    /// @param[out] aIsExact 最適値なら @c true 。
+    ///
+    /// @return 燃料の下界。
+    int LowerBound::Compute(const Problem& aProblem, bool& aIsExact)
+    {
+        const int n = aProblem.itemCount;
+        const int truckWeight = Parameter::TruckWeight;
+        aIsExact = true;
+        if (n == 0) {
+            return 0;
+        }
+
+        const int setCount = 1 << n;
+        std::vector<int> setWeight(setCount, 0);
+        for (int set = 1; set < setCount; ++set) {
+            const int low = set & -set;
+            setWeight[set] = setWeight[set ^ low] + aProblem.weight[BitCount(low - 1)];
+        }
+
+        // h(R, j) は j を含まない R についてだけ求める。R から 1 つ除いた集合は R より小さい。
+        std::vector<int> rest(static_cast<size_t>(setCount) * n, InfeasibleFuel);
+        for (int set = 0; set < setCount; ++set) {
+            const int load = truckWeight + setWeight[set];
+            for (int from = 0; from < n; ++from) {
+                if (set & (1 << from)) {
+                    continue;
+                }
+                int best = InfeasibleFuel;
+                if (set == 0) {
+                    best = aProblem.distance[from][OfficePoint] * truckWeight;
+                }
+                for (int next = 0; next < n; ++next) {
+                    if (set & (1 << next)) {
+                        best = std::min(best, aProblem.distance[from][next] * load + rest[(set ^ (1 << next)) * n + next]);
+                    }
+                }
+                rest[set * n + from] = best;
+            }
+        }
+        std::vector<int> tour(setCount, 0);
+        for (int set = 1; set < setCount; ++set) {
+            const int load = truckWeight + setWeight[set];
+            int best = InfeasibleFuel;
+            for (int next = 0; next < n; ++next) {
+                if (set & (1 << next)) {
+                    best = std::min(best, aProblem.distance[OfficePoint][next] * load + rest[(set ^ (1 << next)) * n + next]);
+                }
+            }
+            tour[set] = best;
+        }
+
+        int fixedSets[Parameter::PeriodCount] = {};
+        int freeSet = 0;
+        for (int i = 0; i < n; ++i) {
+            if (aProblem.period[i] < 0) {
+                freeSet |= 1 << i;
+            } else {
+                HPC_RANGE_ASSERT_MIN_UB_I(aProblem.period[i], 0, Parameter::PeriodCount);
+                fixedSets[aProblem.period[i]] |= 1 << i;
+            }
+        }
+
+        if (BitCount(freeSet) <= ExactFreeItemMax) {
+            // 使った時間帯指定なしの荷物の集合ごとに、そこまでの時間帯の最小の燃料を持つ。
+            std::vector<int> best(setCount, InfeasibleFuel);
+            std::vector<int> next(setCount, InfeasibleFuel);
+            best[0] = 0;
+            for (int period = 0; period < Parameter::PeriodCount; ++period) {
+                std::fill(next.begin(), next.end(), InfeasibleFuel);
+                for (int used = freeSet; ; used = (used - 1) & freeSet) {
+                    if (best[used] < InfeasibleFuel) {
+                        const int remain = freeSet ^ used;
+                        for (int add = remain; ; add = (add - 1) & remain) {
+                            const int set = fixedSets[period] | add;
+                            if (setWeight[set] <= Parameter::TruckWeightCapacity) {
+                                next[used | add] = std::min(next[used | add], best[used] + tour[set]);
+                            }
+                            if (add == 0) {
+                                break;
+                            }
+                        }
+                    }
+                    if (used == 0) {
+                        break;
+                    }
+                }
+                best.swap(next);
+            }
+            return best[freeSet];
+        }
+
+        // 緩和による下界。
+        aIsExact = false;
+        int carryBound = truckWeight * MinimumSpanningTree(aProblem);
+        for (int i = 0; i < n; ++i) {
+            carryBound += aProblem.weight[i] * aProblem.distance[OfficePoint][i];
+        }
+        int fixedBound = 0;
+        for (int period = 0; period < Parameter::PeriodCount; ++period) {
+            fixedBound += tour[fixedSets[period]];
+        }
+        return std::max(carryBound, fixedBound);
+    }
+}
+//------------------------------------------------------------------------------
+// EOF
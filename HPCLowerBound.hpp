@@ -0,0 +1,68 @@
+//------------------------------------------------------------------------------
+/// @file
+/// @brief LowerBound クラス
+/// @author ハル研究所プログラミングコンテスト実行委員会
+///
+/// @copyright  Copyright (c) 2015 HAL Laboratory, Inc.
+/// @attention  このファイルの利用は、同梱のREADMEにある
+///             利用条件に従ってください
+
+//------------------------------------------------------------------------------
+#pragma once
+
+#include <vector>
+#include "HPCParameter.hpp"
+#include "HPCStageState.hpp"
+
+namespace hpc {
+    class Stage;
+
+    //------------------------------------------------------------------------------
+    /// ステージごとに燃料の下界を求め、実際の計画との差(最適性ギャップ)を表示します。
+    ///
+    /// ステージが終わるたびに、営業所と配達先の間の最短距離と実際の燃料だけを控えておき、
+    /// 下界の計算は print でまとめて行います。実行中の制限時間には影響しません。
+    ///
+    /// 下界は次のように求めます。
+    /// - 時間帯指定のない荷物が ExactFreeItemMax 個以下なら、全ての分け方を動的計画法で調べた最適値
+    /// - それより多ければ、次の緩和の大きい方
+    ///   - 重み付き最小全域木: トラック自身の重さ × 営業所と配達先の最小全域木 + 各荷物の重さ × 営業所からの距離
+    ///   - 時間帯指定のある荷物だけを、指定の時間帯で最適に運ぶ燃料
+    class LowerBound
+    {
+    public:
+        /// 下界を求めるための問題
+        struct Problem {
+            int itemCount;                                          ///< 荷物の数
+            int weight[Parameter::ItemCountMax];                    ///< 荷物の重さ
+            int period[Parameter::ItemCountMax];                    ///< 荷物の指定時間帯。指定がなければ -1
+            int distance[Parameter::ItemCountMax + 1][Parameter::ItemCountMax + 1]; ///< 地点間の最短距離(最後が営業所)
+        };
+
+        LowerBound();
+
+        void enable();                                      ///< 有効にします。
+        bool isEnabled()const;                             ///< 有効かどうかを返します。
+        void addStage(int aStageIndex, const Stage& aStage); ///< 終了したステージを控えます。
+        void print()const;                                 ///< 下界とギャップを表示します。
+
+        static void BuildProblem(const Stage& aStage, Problem& aProblem); ///< ステージから問題を作ります。
+        static int Compute(const Problem& aProblem, bool& aIsExact); ///< 燃料の下界を求めます。
+
+        static const int ExactFreeItemMax = 13;             ///< 最適値を求める、時間帯指定のない荷物の最大数
+
+    private:
+        /// 控えたステージ
+        struct Entry {
+            Problem problem;        ///< 問題
+            int area;               ///< フィールドの面積(得点の計算に使う)
+            int fuel;               ///< 実際に消費した燃料
+            StageState state;       ///< 終了時の状態
+        };
+
+        bool mIsEnabled;                                    ///< 有効か
+        std::vector<Entry> mEntries;                        ///< [ステージ番号] 控えたステージ
+    };
+}
+//------------------------------------------------------------------------------
+// EOF
@@ -9,9 +9,15 @@
 
 //------------------------------------------------------------------------------
 
+#include <cstdlib>
 #include <cstring>
 #include "HPCCommon.hpp"
+#include "HPCMemory.hpp"
+#include "HPCPerfCounter.hpp"
+#include "HPCProfiler.hpp"
 #include "HPCSimulation.hpp"
+#include "HPCSolver.hpp"
+#include "HPCTrace.hpp"
 
 //------------------------------------------------------------------------------
 namespace {
@@ -39,35 +45,185 @@ namespace {
 ///  ------------|----------------------------------------------
 ///   -n         | デバッグを行いません。
 ///   -j         | デバッグを行わず、結果を JSON で出力します。
+///   -seed x,y,z,w | ステージを生成する乱数のシードを指定します。(10 進数か 0x で始まる 16 進数)
+///   -s solver  | 解答を選びます。登録されている名前か、共有ライブラリ(make plugins で作る .so)のパスを指定します。(list で一覧を表示)
+///   -t mode    | 制限時間の計測方法を指定します。(wall, process, thread。既定は process 。制限時間があるときは、監視スレッドの分を数えない thread)
+///   -p         | 終了時に処理ごとの所要時間を表示します。(make PROFILE=1 でビルドしたときのみ)
+///   -m file    | ステージごとの指標を file に書き出します。(拡張子が .csv なら CSV 、それ以外なら NDJSON)
+///   -c file    | 処理の区間を Chrome の trace event 形式で file に書き出します。(chrome://tracing や Perfetto で表示)
+///   -a         | 終了時に記録の大きさ、処理の区切りごとの常駐メモリ量、動的確保の集計を表示します。(動的確保は make MEMORY=1 でビルドしたときのみ)
+///   -f         | 終了時に、壁への衝突や遠回りで無駄にした燃料をステージの種類ごとに表示します。
+///   -g         | 終了時に、ステージごとの燃料の下界と、実際の燃料との差(最適性ギャップ)を表示します。
+///   -r         | 終了時に、ステージごとの解答の待ち時間(Answer::Init と Answer::InitPeriod)の分位点を表示します。
+///   -l msec    | -r に加えて、待ち時間の p99 が msec ミリ秒を超えたら BREACHED と表示します。
+///   -lf msec   | -l と同じですが、超えたら終了コード 1 で終了します。
+///   -e         | 終了時に Answer::Init と Stage::runTurn のハードウェアカウンタの値を表示します。(make PERF=1 でビルドしたときのみ。Linux 以外やカウンタを開けないときは時間のみ)
+///
+/// -n, -j, -jd はどれか 1 つまで指定できます。
 ///
 int main(int argc, const char* argv[])
 {
     Operation operation = Operation_Normal;
+    hpc::TimerMode timerMode = hpc::TimerMode_ProcessCpu;
+    bool isTimerModeSpecified = false;
+    bool printsProfile = false;
+    const char* metricsPath = 0;
+    const char* tracePath = 0;
+    bool analyzesPlan = false;
+    uint seeds[hpc::Random::SeedCount];
+    bool isSeedSpecified = false;
+    bool computesLowerBound = false;
+    bool reportsLatency = false;
+    double latencySloMilliSec = 0.0;
+    bool failsOnSloBreach = false;
     
-    // 引数は 1 つまで有効。
-    if (argc > 2) {
-        HPC_PRINT("Invalid Argument.\n");
-        return 0;
-    }
-    // 引数がある場合、引数を記録する。
-    else if (argc > 1) {
-        if (!std::strcmp(argv[1], "-n")) {
-            operation = Operation_NoDebug;
+    // 引数を順に記録する。
+    for (int i = 1; i < argc; ++i) {
+        Operation argOperation = Operation_TERM;
+        if (!std::strcmp(argv[i], "-n")) {
+            argOperation = Operation_NoDebug;
+        }
+        else if (!std::strcmp(argv[i], "-j")) {
+            argOperation = Operation_OutputJsonCompressed;
+        }
+        else if (!std::strcmp(argv[i], "-jd")) {
+            argOperation = Operation_OutputJson;
+        }
+        else if (!std::strcmp(argv[i], "-seed")) {
+            if (i + 1 >= argc || !hpc::Random::ParseSeeds(argv[i + 1], seeds)) {
+                HPC_PRINT("Invalid Argument: -seed needs four seeds (x,y,z,w).\n");
+                return 0;
+            }
+            ++i;
+            isSeedSpecified = true;
+            continue;
+        }
+        else if (!std::strcmp(argv[i], "-s")) {
+            if (i + 1 >= argc) {
+                HPC_PRINT("Invalid Argument: -s needs a solver name or a shared library path.\n");
+                return 0;
+            }
+            ++i;
+            if (!std::strcmp(argv[i], "list")) {
+                hpc::Solver::PrintList();
+                return 0;
+            }
+            if (!hpc::Solver::Select(argv[i])) {
+                HPC_PRINT("Invalid Argument: %s is unknown solver.\n", argv[i]);
+                hpc::Solver::PrintList();
+                return 0;
+            }
+            continue;
+        }
+        else if (!std::strcmp(argv[i], "-t")) {
+            if (i + 1 >= argc) {
+                HPC_PRINT("Invalid Argument: -t needs a timer mode.\n");
+                return 0;
+            }
+            ++i;
+            int mode = 0;
+            while (mode < hpc::TimerMode_TERM && std::strcmp(argv[i], hpc::Timer::ModeName(static_cast<hpc::TimerMode>(mode)))) {
+                ++mode;
+            }
+            if (mode == hpc::TimerMode_TERM) {
+                HPC_PRINT("Invalid Argument: %s is unknown timer mode.\n", argv[i]);
+                return 0;
+            }
+            timerMode = static_cast<hpc::TimerMode>(mode);
+            isTimerModeSpecified = true;
+            continue;
+        }
+        else if (!std::strcmp(argv[i], "-p")) {
+            printsProfile = true;
+            continue;
         }
-        else if (!std::strcmp(argv[1], "-j")) {
-            operation = Operation_OutputJsonCompressed;
+        else if (!std::strcmp(argv[i], "-a")) {
+            hpc::Memory::Enable();
+            continue;
         }
-        else if (!std::strcmp(argv[1], "-jd")) {
-            operation = Operation_OutputJson;
+        else if (!std::strcmp(argv[i], "-f")) {
+            analyzesPlan = true;
+            continue;
+        }
+        else if (!std::strcmp(argv[i], "-g")) {
+            computesLowerBound = true;
+            continue;
+        }
+        else if (!std::strcmp(argv[i], "-r")) {
+            reportsLatency = true;
+            continue;
+        }
+        else if (!std::strcmp(argv[i], "-l") || !std::strcmp(argv[i], "-lf")) {
+            if (i + 1 >= argc || std::atof(argv[i + 1]) <= 0.0) {
+                HPC_PRINT("Invalid Argument: %s needs a positive latency in milliseconds.\n", argv[i]);
+                return 0;
+            }
+            failsOnSloBreach = !std::strcmp(argv[i], "-lf");
+            latencySloMilliSec = std::atof(argv[++i]);
+            continue;
+        }
+        else if (!std::strcmp(argv[i], "-e")) {
+            hpc::PerfCounter::Enable();
+            continue;
+        }
+        else if (!std::strcmp(argv[i], "-m")) {
+            if (i + 1 >= argc) {
+                HPC_PRINT("Invalid Argument: -m needs a file path.\n");
+                return 0;
+            }
+            metricsPath = argv[++i];
+            continue;
+        }
+        else if (!std::strcmp(argv[i], "-c")) {
+            if (i + 1 >= argc) {
+                HPC_PRINT("Invalid Argument: -c needs a file path.\n");
+                return 0;
+            }
+            tracePath = argv[++i];
+            continue;
         }
         else {
-            HPC_PRINT("Invalid Argument: %s is unknown command.\n", argv[1]);
+            HPC_PRINT("Invalid Argument: %s is unknown command.\n", argv[i]);
             return 0;
         }
+
+        if (operation != Operation_Normal) {
+            HPC_PRINT("Invalid Argument: %s conflicts with a previous option.\n", argv[i]);
+            return 0;
+        }
+        operation = argOperation;
     }
     // プログラムの実行
     {
+        if (isTimerModeSpecified) {
+            sSim.setTimerMode(timerMode);
+        }
+        if (isSeedSpecified) {
+            sSim.setRandom(hpc::Random(seeds[0], seeds[1], seeds[2], seeds[3]));
+        }
+        if (analyzesPlan) {
+            sSim.enablePlanAnalyzer();
+        }
+        if (computesLowerBound) {
+            sSim.enableLowerBound();
+        }
+        if (reportsLatency) {
+            sSim.enableLatencyReport();
+        }
+        if (latencySloMilliSec > 0.0) {
+            sSim.setLatencySlo(latencySloMilliSec);
+        }
+        if (metricsPath != 0 && !sSim.openMetrics(metricsPath)) {
+            HPC_PRINT("Invalid Argument: cannot open %s.\n", metricsPath);
+            return 0;
+        }
+        if (tracePath != 0 && !hpc::Trace::Open(tracePath)) {
+            HPC_PRINT("Invalid Argument: cannot open %s.\n", tracePath);
+            return 0;
+        }
+        hpc::Memory::Snapshot("start");
         sSim.run();
+        hpc::Memory::Snapshot("run");
 
         switch (operation) {
         case Operation_Normal:
@@ -91,6 +247,19 @@ int main(int argc, const char* argv[])
             HPC_SHOULD_NOT_REACH_HERE();
             break;
         }
+        hpc::Memory::Snapshot("output");
+        if (printsProfile) {
+            hpc::Profiler::Print();
+        }
+        sSim.outputPlanAnalysis();
+        sSim.outputLowerBound();
+        sSim.outputLatencyReport();
+        hpc::PerfCounter::Print();
+        hpc::Memory::Print();
+        hpc::Trace::Close();
+        if (failsOnSloBreach && sSim.isLatencySloBreached()) {
+            return 1;
+        }
     }
 
     return 0;
@@ -0,0 +1,346 @@
+//------------------------------------------------------------------------------
+/// @file
+/// @brief HPCMemory.hpp の実装
+/// @author ハル研究所プログラミングコンテスト実行委員会
+///
+/// @copyright  Copyright (c) 2015 HAL Laboratory, Inc.
+/// @attention  このファイルの利用は、同梱のREADMEにある
+///             利用条件に従ってください
+
+//------------------------------------------------------------------------------
+
+#include "HPCMemory.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include "HPCCommon.hpp"
+#include "HPCParameter.hpp"
+#include "HPCRecord.hpp"
+#include "HPCSimulation.hpp"
+
+#if !defined(_WIN32)
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
+
+namespace {
+    using namespace hpc;
+
+    /// MemoryTag の表示名。
+    const char* const TagNames[MemoryTag_TERM] = {
+        "Other",
+        "Solver",
+        "FieldCache",
+        "Trace",
+    };
+
+    /// 記録する区切りの最大数。
+    const int SnapshotMax = 16;
+
+    /// 区切りでの使用量
+    struct Snapshot {
+        const char* phase;      ///< 区切りの名前
+        long residentKiB;       ///< その時点の常駐メモリ量
+        long peakResidentKiB;   ///< その時点までの最大常駐メモリ量
+        int64_t heapBytes;      ///< その時点で確保したままのバイト数 (MEMORY=1 のときのみ)
+    };
+
+    /// MemoryTag ごとの動的確保の集計。operator new から触るので、静的に 0 で初期化されるものだけを使う。
+    struct AtomicTagStats {
+        std::atomic<int64_t> allocCount;
+        std::atomic<int64_t> freeCount;
+        std::atomic<int64_t> totalBytes;
+        std::atomic<int64_t> liveBytes;
+        std::atomic<int64_t> peakBytes;
+    };
+
+    bool sIsEnabled = false;                            ///< 終了時に表示するか
+    Snapshot sSnapshots[SnapshotMax];                   ///< 記録した区切り
+    int sSnapshotCount = 0;                             ///< 記録した区切りの数
+    AtomicTagStats sTagStats[MemoryTag_TERM];           ///< MemoryTag ごとの集計
+    thread_local MemoryTag tTag = MemoryTag_Other;      ///< 呼び出したスレッドの MemoryTag
+
+    //------------------------------------------------------------------------------
+    /// @return KiB 単位に切り上げた値。
+    long ToKiB(int64_t aBytes)
+    {
+        return static_cast<long>((aBytes + 1023) / 1024);
+    }
+
+#ifdef HPC_MEMORY
+    /// 確保した領域の先頭に置く情報。解放時に大きさと MemoryTag を知るために使う。
+    struct AllocHeader {
+        size_t size;            ///< 要求された大きさ
+        MemoryTag tag;          ///< 確保したときの MemoryTag
+    };
+
+    /// AllocHeader の分だけずらす量。operator new の返す領域の整列を保つ。
+    const size_t AllocHeaderSize = 16;
+    static_assert(sizeof(AllocHeader) <= AllocHeaderSize, "AllocHeader is too large.");
+
+    //------------------------------------------------------------------------------
+    /// 領域を確保し、呼び出したスレッドの MemoryTag で数えます。
+    ///
+    /// @return 確保した領域。確保できなければ 0 。
+    void* Allocate(size_t aSize)
+    {
+        char* ptr = static_cast<char*>(std::malloc(aSize + AllocHeaderSize));
+        if (ptr == 0) {
+            return 0;
+        }
+        AllocHeader* header = reinterpret_cast<AllocHeader*>(ptr);
+        header->size = aSize;
+        header->tag = tTag;
+
+        AtomicTagStats& stats = sTagStats[header->tag];
+        const int64_t size = static_cast<int64_t>(aSize);
+        stats.allocCount.fetch_add(1, std::memory_order_relaxed);
+        stats.totalBytes.fetch_add(size, std::memory_order_relaxed);
+        const int64_t live = stats.liveBytes.fetch_add(size, std::memory_order_relaxed) + size;
+        int64_t peak = stats.peakBytes.load(std::memory_order_relaxed);
+        while (peak < live && !stats.peakBytes.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {
+        }
+        return ptr + AllocHeaderSize;
+    }
+
+    //------------------------------------------------------------------------------
+    /// Allocate で確保した領域を解放します。確保したときの MemoryTag から差し引きます。
+    void Free(void* aPtr)
+    {
+        if (aPtr == 0) {
+            return;
+        }
+        char* ptr = static_cast<char*>(aPtr) - AllocHeaderSize;
+        const AllocHeader* header = reinterpret_cast<const AllocHeader*>(ptr);
+        AtomicTagStats& stats = sTagStats[header->tag];
+        stats.freeCount.fetch_add(1, std::memory_order_relaxed);
+        stats.liveBytes.fetch_sub(static_cast<int64_t>(header->size), std::memory_order_relaxed);
+        std::free(ptr);
+    }
+#endif
+
+    //------------------------------------------------------------------------------
+    /// @return 全 MemoryTag で確保したままのバイト数。
+    int64_t TotalLiveBytes()
+    {
+        int64_t bytes = 0;
+        for (int i = 0; i < MemoryTag_TERM; ++i) {
+            bytes += sTagStats[i].liveBytes.load(std::memory_order_relaxed);
+        }
+        return bytes;
+    }
+}
+
+#ifdef HPC_MEMORY
+//------------------------------------------------------------------------------
+// 動的確保を数えるために、全ての operator new / delete を置き換える。
+void* operator new(std::size_t aSize)
+{
+    void* ptr = Allocate(aSize);
+    if (ptr == 0) {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void* operator new[](std::size_t aSize)
+{
+    return operator new(aSize);
+}
+
+void* operator new(std::size_t aSize, const std::nothrow_t&) noexcept
+{
+    return Allocate(aSize);
+}
+
+void* operator new[](std::size_t aSize, const std::nothrow_t&) noexcept
+{
+    return Allocate(aSize);
+}
+
+void operator delete(void* aPtr) noexcept
+{
+    Free(aPtr);
+}
+
+void operator delete[](void* aPtr) noexcept
+{
+    Free(aPtr);
+}
+
+void operator delete(void* aPtr, const std::nothrow_t&) noexcept
+{
+    Free(aPtr);
+}
+
+void operator delete[](void* aPtr, const std::nothrow_t&) noexcept
+{
+    Free(aPtr);
+}
+#endif
+
+namespace hpc {
+
+    //------------------------------------------------------------------------------
+    /// 終了時に Print で表示するようにします。
+    void Memory::Enable()
+    {
+        sIsEnabled = true;
+    }
+
+    //------------------------------------------------------------------------------
+    /// @return Enable を呼んでいれば @c true 。
+    bool Memory::IsEnabled()
+    {
+        return sIsEnabled;
+    }
+
+    //------------------------------------------------------------------------------
+    /// @return make MEMORY=1 でビルドしていて、動的確保を数えているなら @c true 。
+    bool Memory::IsHooked()
+    {
+#ifdef HPC_MEMORY
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    //------------------------------------------------------------------------------
+    /// 呼び出したスレッドがこれから確保するメモリを数える MemoryTag を設定します。
+    ///
+    /// @param[in] aTag 設定する MemoryTag 。
+    ///
+    /// @return 元の MemoryTag 。
+    MemoryTag Memory::SetTag(MemoryTag aTag)
+    {
+        HPC_ENUM_ASSERT(MemoryTag, aTag);
+        const MemoryTag prevTag = tTag;
+        tTag = aTag;
+        return prevTag;
+    }
+
+    //------------------------------------------------------------------------------
+    /// @param[in] aTag 集計を取得する MemoryTag 。
+    ///
+    /// @return 集計。動的確保を数えていなければ全て 0 。
+    Memory::TagStats Memory::Stats(MemoryTag aTag)
+    {
+        HPC_ENUM_ASSERT(MemoryTag, aTag);
+        const AtomicTagStats& stats = sTagStats[aTag];
+        TagStats result;
+        result.allocCount = stats.allocCount.load(std::memory_order_relaxed);
+        result.freeCount = stats.freeCount.load(std::memory_order_relaxed);
+        result.totalBytes = stats.totalBytes.load(std::memory_order_relaxed);
+        result.liveBytes = stats.liveBytes.load(std::memory_order_relaxed);
+        result.peakBytes = stats.peakBytes.load(std::memory_order_relaxed);
+        return result;
+    }
+
+    //------------------------------------------------------------------------------
+    /// 処理の区切りで、常駐メモリ量と確保したままのバイト数を記録します。
+    ///
+    /// 記録は SnapshotMax 個までで、それ以降は無視します。メインスレッドから呼んでください。
+    ///
+    /// @param[in] aPhase 区切りの名前。文字列は Print まで有効であること。
+    void Memory::Snapshot(const char* aPhase)
+    {
+        if (!sIsEnabled || sSnapshotCount >= SnapshotMax) {
+            return;
+        }
+        ::Snapshot& snapshot = sSnapshots[sSnapshotCount++];
+        snapshot.phase = aPhase;
+        snapshot.residentKiB = ResidentKiB();
+        // 最大常駐メモリ量は遅れて更新されることがあるので、現在の量を下回らないようにする。
+        snapshot.peakResidentKiB = std::max(PeakResidentKiB(), snapshot.residentKiB);
+        snapshot.heapBytes = TotalLiveBytes();
+    }
+
+    //------------------------------------------------------------------------------
+    /// 集計結果を表示します。
+    ///
+    /// 静的な記録の大きさは RepeatCount を 4 にしたときの見込みも出します。
+    void Memory::Print()
+    {
+        if (!sIsEnabled) {
+            return;
+        }
+        const int stagesPerRepeat = Parameter::GameStageCount / Parameter::RepeatCount;
+        HPC_PRINT("Static footprint [KiB]\n");
+        HPC_PRINT("  %-28s %10ld\n", "Simulation", ToKiB(sizeof(Simulation)));
+        HPC_PRINT("  %-28s %10ld (%d stages)\n", "Record", ToKiB(sizeof(Record)), Parameter::GameStageCount);
+        HPC_PRINT("  %-28s %10ld\n", "RecordStage", ToKiB(sizeof(RecordStage)));
+#ifdef DEBUG
+        HPC_PRINT("    %-26s %10ld (%d turns)\n", "TurnResult", ToKiB(sizeof(TurnResult) * (Parameter::GameTurnPerStage + 1)), Parameter::GameTurnPerStage + 1);
+        HPC_PRINT("    %-26s %10ld\n", "Field", ToKiB(sizeof(Field)));
+        HPC_PRINT("    %-26s %10ld\n", "ItemCollection", ToKiB(sizeof(ItemCollection)));
+#endif
+        HPC_PRINT("  %-28s %10ld\n", "Record at RepeatCount 4", ToKiB(static_cast<int64_t>(sizeof(RecordStage)) * stagesPerRepeat * 4));
+
+        HPC_PRINT("Resident memory [KiB]\n");
+        HPC_PRINT("  %-28s %10s %10s %10s\n", "Phase", "Current", "Peak", "Heap");
+        for (int i = 0; i < sSnapshotCount; ++i) {
+            const ::Snapshot& snapshot = sSnapshots[i];
+            HPC_PRINT("  %-28s %10ld %10ld %10ld\n", snapshot.phase, snapshot.residentKiB, snapshot.peakResidentKiB, ToKiB(snapshot.heapBytes));
+        }
+
+        if (!IsHooked()) {
+            HPC_PRINT("Heap allocations are not counted. (build with make MEMORY=1)\n");
+            return;
+        }
+        HPC_PRINT("Heap by tag\n");
+        HPC_PRINT("  %-28s %10s %10s %12s %10s %10s\n", "Tag", "Allocs", "Frees", "Total[KiB]", "Live[KiB]", "Peak[KiB]");
+        for (int i = 0; i < MemoryTag_TERM; ++i) {
+            const TagStats stats = Stats(static_cast<MemoryTag>(i));
+            HPC_PRINT("  %-28s %10lld %10lld %12ld %10ld %10ld\n", TagNames[i],
+                static_cast<long long>(stats.allocCount), static_cast<long long>(stats.freeCount),
+                ToKiB(stats.totalBytes), ToKiB(stats.liveBytes), ToKiB(stats.peakBytes));
+        }
+    }
+
+    //------------------------------------------------------------------------------
+    /// @return プロセスの現在の常駐メモリ量[KiB]。取得できなければ 0 。
+    long Memory::ResidentKiB()
+    {
+#if defined(__linux__)
+        std::FILE* file = std::fopen("/proc/self/statm", "r");
+        if (file == 0) {
+            return 0;
+        }
+        long sizePages = 0;
+        long residentPages = 0;
+        const int readCount = std::fscanf(file, "%ld %ld", &sizePages, &residentPages);
+        std::fclose(file);
+        if (readCount != 2) {
+            return 0;
+        }
+        return residentPages * (sysconf(_SC_PAGESIZE) / 1024);
+#else
+        return 0;
+#endif
+    }
+
+    //------------------------------------------------------------------------------
+    /// @return プロセスの最大常駐メモリ量[KiB]。取得できなければ 0 。
+    long Memory::PeakResidentKiB()
+    {
+#if defined(_WIN32)
+        return 0;
+#else
+        rusage usage;
+        if (getrusage(RUSAGE_SELF, &usage) != 0) {
+            return 0;
+        }
+#if defined(__APPLE__)
+        return usage.ru_maxrss / 1024;
+#else
+        return usage.ru_maxrss;
+#endif
+#endif
+    }
+}
+//------------------------------------------------------------------------------
+// EOF
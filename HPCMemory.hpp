@@ -0,0 +1,99 @@
+//------------------------------------------------------------------------------
+/// @file
+/// @brief Memory クラス
+/// @author ハル研究所プログラミングコンテスト実行委員会
+///
+/// @copyright  Copyright (c) 2015 HAL Laboratory, Inc.
+/// @attention  このファイルの利用は、同梱のREADMEにある
+///             利用条件に従ってください
+
+//------------------------------------------------------------------------------
+#pragma once
+
+#include <cstdint>
+
+namespace hpc {
+
+    //------------------------------------------------------------------------------
+    /// 動的に確保したメモリをどの処理の分として数えるかを表します。
+    enum MemoryTag {
+        MemoryTag_Other,            ///< 以下のどれでもないもの
+        MemoryTag_Solver,           ///< 解答の作業領域 (Answer::Init, Answer::GetNextAction)
+        MemoryTag_FieldCache,       ///< 解答がフィールドごとに作る経路の表
+        MemoryTag_Trace,            ///< トレースの記録バッファ
+        MemoryTag_TERM
+    };
+
+    //------------------------------------------------------------------------------
+    /// メモリの使用量を集計します。
+    ///
+    /// - 静的に確保している記録(Record)などの大きさ
+    /// - 処理の区切りでのプロセスの常駐メモリ量(RSS)と、その最大値
+    /// - MemoryTag ごとの動的確保の回数とバイト数 (make MEMORY=1 でビルドしたときのみ)
+    ///
+    /// 動的確保は、MEMORY=1 のときに置き換える operator new / delete で数えます。
+    /// どの MemoryTag で数えるかは、スレッドごとに MemoryTagScope で切り替えます。
+    class Memory
+    {
+    public:
+        /// MemoryTag ごとの動的確保の集計
+        struct TagStats {
+            int64_t allocCount;     ///< 確保した回数
+            int64_t freeCount;      ///< 解放した回数
+            int64_t totalBytes;     ///< 確保したバイト数の合計
+            int64_t liveBytes;      ///< 確保したまま解放していないバイト数
+            int64_t peakBytes;      ///< liveBytes の最大値
+        };
+
+        static void Enable();                               ///< 終了時に表示するようにします。
+        static bool IsEnabled();                            ///< 表示するかどうかを返します。
+        static bool IsHooked();                             ///< 動的確保を数えているかどうかを返します。
+        static MemoryTag SetTag(MemoryTag aTag);            ///< 呼び出したスレッドの MemoryTag を設定します。
+        static TagStats Stats(MemoryTag aTag);              ///< MemoryTag ごとの集計を返します。
+        static void Snapshot(const char* aPhase);           ///< 処理の区切りで使用量を記録します。
+        static void Print();                                ///< 集計結果を表示します。
+
+        static long ResidentKiB();                          ///< プロセスの現在の常駐メモリ量を返します。
+        static long PeakResidentKiB();                      ///< プロセスの最大常駐メモリ量を返します。
+
+    private:
+        Memory();
+    };
+
+    //------------------------------------------------------------------------------
+    /// 生成から破棄までの間、呼び出したスレッドの動的確保を指定の MemoryTag で数えます。
+    class MemoryTagScope
+    {
+    public:
+        explicit MemoryTagScope(MemoryTag aTag)
+            : mPrevTag(Memory::SetTag(aTag))
+        {
+        }
+
+        ~MemoryTagScope()
+        {
+            Memory::SetTag(mPrevTag);
+        }
+
+    private:
+        MemoryTagScope(const MemoryTagScope&);
+        MemoryTagScope& operator=(const MemoryTagScope&);
+
+        const MemoryTag mPrevTag;                           ///< 元の MemoryTag
+    };
+}
+
+//------------------------------------------------------------------------------
+/// スコープの終わりまで、呼び出したスレッドの動的確保を aTag で数えます。
+/// HPC_MEMORY を定義しないとき (make MEMORY=1 でないとき) は何も生成しません。
+#define HPC_MEMORY_CONCAT_IMPL(a, b) a##b
+#define HPC_MEMORY_CONCAT(a, b) HPC_MEMORY_CONCAT_IMPL(a, b)
+
+#ifdef HPC_MEMORY
+#define HPC_MEMORY_TAG_SCOPE(aTag) \
+    ::hpc::MemoryTagScope HPC_MEMORY_CONCAT(hpcMemoryTagScope, __LINE__)(aTag)
+#else
+#define HPC_MEMORY_TAG_SCOPE(aTag) do {} while (false)
+#endif
+//------------------------------------------------------------------------------
+// EOF
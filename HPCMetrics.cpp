@@ -0,0 +1,179 @@
+//------------------------------------------------------------------------------
+/// @file
+/// @brief HPCMetrics.hpp の実装
+/// @author ハル研究所プログラミングコンテスト実行委員会
+///
+/// @copyright  Copyright (c) 2015 HAL Laboratory, Inc.
+/// @attention  このファイルの利用は、同梱のREADMEにある
+///             利用条件に従ってください
+
+//------------------------------------------------------------------------------
+
+#include "HPCMetrics.hpp"
+
+#include <cstring>
+#include "HPCCommon.hpp"
+#include "HPCMemory.hpp"
+#include "HPCStage.hpp"
+
+namespace {
+    using namespace hpc;
+
+    /// 1 つのステージの種類に含まれるステージ数。
+    const int StagesPerCategory = Parameter::GameStageCount / LevelDesigner::CategoryCount;
+}
+
+namespace hpc {
+
+    //------------------------------------------------------------------------------
+    /// クラスのインスタンスを生成します。出力先は開いていません。
+    Metrics::Metrics()
+        : mFile(0)
+        , mFormat(MetricsFormat_Csv)
+    {
+        for (int i = 0; i < LevelDesigner::CategoryCount; ++i) {
+            mRollups[i].clear();
+        }
+    }
+
+    //------------------------------------------------------------------------------
+    /// インスタンスを破棄します。出力先が開いていれば閉じます。
+    Metrics::~Metrics()
+    {
+        close();
+    }
+
+    //------------------------------------------------------------------------------
+    /// 出力先を開き、必要なら見出しを書きます。
+    ///
+    /// 拡張子が .csv なら CSV 、それ以外なら NDJSON で書きます。
+    ///
+    /// @param[in] aPath 出力先のファイルパス。
+    ///
+    /// @return 開けたら @c true 。
+    bool Metrics::open(const char* aPath)
+    {
+        close();
+        const size_t length = std::strlen(aPath);
+        mFormat = (length >= 4 && !std::strcmp(aPath + length - 4, ".csv")) ? MetricsFormat_Csv : MetricsFormat_Ndjson;
+        mFile = std::fopen(aPath, "w");
+        if (mFile == 0) {
+            return false;
+        }
+        for (int i = 0; i < LevelDesigner::CategoryCount; ++i) {
+            mRollups[i].clear();
+        }
+        writeHeader();
+        return true;
+    }
+
+    //------------------------------------------------------------------------------
+    /// 出力先を閉じます。
+    void Metrics::close()
+    {
+        if (mFile != 0) {
+            std::fclose(mFile);
+            mFile = 0;
+        }
+    }
+
+    //------------------------------------------------------------------------------
+    /// @return 出力先が開いていれば @c true 。
+    bool Metrics::isOpen()const
+    {
+        return mFile != 0;
+    }
+
+    //------------------------------------------------------------------------------
+    /// 終了したステージの指標を書きます。
+    ///
+    /// ステージの種類の最後のステージなら、続けてその種類の集計を書きます。
+    ///
+    /// @param[in] aStageIndex ステージ番号。
+    /// @param[in] aStage 終了したステージ。
+    void Metrics::writeStage(int aStageIndex, const Stage& aStage)
+    {
+        if (mFile == 0) {
+            return;
+        }
+        Rollup stage;
+        stage.clear();
+        stage.stageCount = 1;
+        stage.completeCount = aStage.lastTurnResult().state == StageState_Complete ? 1 : 0;
+        stage.turns = aStage.turn();
+        stage.fuel = aStage.totalCost();
+        stage.score = aStage.score();
+        stage.solveSec = aStage.solveSec();
+        stage.maxSolveSec = aStage.solveSec();
+
+        const int category = LevelDesigner::Category(aStageIndex);
+        writeRow("stage", aStageIndex, category,
+            LevelDesigner::WallDensityIndex(aStageIndex), LevelDesigner::PeriodSpecifiedIndex(aStageIndex), LevelDesigner::ItemCountIndex(aStageIndex),
+            aStage.field().width(), aStage.field().height(), stage);
+
+        Rollup& rollup = mRollups[category];
+        rollup.stageCount += stage.stageCount;
+        rollup.completeCount += stage.completeCount;
+        rollup.turns += stage.turns;
+        rollup.fuel += stage.fuel;
+        rollup.score += stage.score;
+        rollup.solveSec += stage.solveSec;
+        if (rollup.maxSolveSec < stage.maxSolveSec) {
+            rollup.maxSolveSec = stage.maxSolveSec;
+        }
+        if (rollup.stageCount % StagesPerCategory == 0) {
+            writeRow("category", -1, category, LevelDesigner::WallDensityIndex(aStageIndex), -1, -1, -1, -1, rollup);
+        }
+        std::fflush(mFile);
+    }
+
+    //------------------------------------------------------------------------------
+    /// 集計を 0 にします。
+    void Metrics::Rollup::clear()
+    {
+        stageCount = 0;
+        completeCount = 0;
+        turns = 0;
+        fuel = 0;
+        score = 0;
+        solveSec = 0.0;
+        maxSolveSec = 0.0;
+    }
+
+    //------------------------------------------------------------------------------
+    /// CSV なら見出しの行を書きます。
+    void Metrics::writeHeader()
+    {
+        if (mFormat == MetricsFormat_Csv) {
+            std::fprintf(mFile, "kind,stage,category,wallDensityIndex,periodSpecifiedIndex,itemCountIndex,width,height,"
+                "stages,completed,turns,fuel,score,solveMs,maxSolveMs,peakRssKiB\n");
+        }
+    }
+
+    //------------------------------------------------------------------------------
+    /// 1 行を書きます。集計の行では、種類の中で値が揃わない項目は -1 です。
+    void Metrics::writeRow(const char* aKind, int aStageIndex, int aCategory, int aWallDensityIndex, int aPeriodSpecifiedIndex, int aItemCountIndex,
+        int aWidth, int aHeight, const Rollup& aRollup)
+    {
+        const long peakRss = Memory::PeakResidentKiB();
+        if (mFormat == MetricsFormat_Csv) {
+            std::fprintf(mFile, "%s,%d,%d,%d,%d,%d,%d,%d,%d,%d,%lld,%lld,%lld,%.3f,%.3f,%ld\n",
+                aKind, aStageIndex, aCategory, aWallDensityIndex, aPeriodSpecifiedIndex, aItemCountIndex, aWidth, aHeight,
+                aRollup.stageCount, aRollup.completeCount,
+                static_cast<long long>(aRollup.turns), static_cast<long long>(aRollup.fuel), static_cast<long long>(aRollup.score),
+                aRollup.solveSec * 1e3, aRollup.maxSolveSec * 1e3, peakRss);
+        } else {
+            std::fprintf(mFile, "{\"kind\":\"%s\",\"stage\":%d,\"category\":%d,\"categoryLabel\":\"%s\","
+                "\"wallDensityIndex\":%d,\"periodSpecifiedIndex\":%d,\"itemCountIndex\":%d,\"width\":%d,\"height\":%d,"
+                "\"stages\":%d,\"completed\":%d,\"turns\":%lld,\"fuel\":%lld,\"score\":%lld,"
+                "\"solveMs\":%.3f,\"maxSolveMs\":%.3f,\"peakRssKiB\":%ld}\n",
+                aKind, aStageIndex, aCategory, LevelDesigner::CategoryLabel(aCategory),
+                aWallDensityIndex, aPeriodSpecifiedIndex, aItemCountIndex, aWidth, aHeight,
+                aRollup.stageCount, aRollup.completeCount,
+                static_cast<long long>(aRollup.turns), static_cast<long long>(aRollup.fuel), static_cast<long long>(aRollup.score),
+                aRollup.solveSec * 1e3, aRollup.maxSolveSec * 1e3, peakRss);
+        }
+    }
+}
+//------------------------------------------------------------------------------
+// EOF
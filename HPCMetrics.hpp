@@ -0,0 +1,73 @@
+//------------------------------------------------------------------------------
+/// @file
+/// @brief Metrics クラス
+/// @author ハル研究所プログラミングコンテスト実行委員会
+///
+/// @copyright  Copyright (c) 2015 HAL Laboratory, Inc.
+/// @attention  このファイルの利用は、同梱のREADMEにある
+///             利用条件に従ってください
+
+//------------------------------------------------------------------------------
+#pragma once
+
+#include <cstdio>
+#include <cstdint>
+#include "HPCLevelDesigner.hpp"
+
+namespace hpc {
+    class Stage;
+
+    //------------------------------------------------------------------------------
+    /// 指標の出力形式を表します。
+    enum MetricsFormat {
+        MetricsFormat_Csv,      ///< CSV (1 行目は見出し)
+        MetricsFormat_Ndjson,   ///< 1 行に 1 つの JSON オブジェクト
+        MetricsFormat_TERM
+    };
+
+    //------------------------------------------------------------------------------
+    /// ステージごとの指標をファイルへ書き出します。
+    ///
+    /// ステージが終わるたびに 1 行書き、ステージの種類(LevelDesigner::Category)の
+    /// 最後のステージが終わったら、その種類の集計を 1 行書きます。
+    /// どちらも書いた時点でファイルへ流すので、実行の途中でも読めます。
+    class Metrics
+    {
+    public:
+        Metrics();
+        ~Metrics();
+
+        bool open(const char* aPath);                       ///< 出力先を開きます。
+        void close();                                       ///< 出力先を閉じます。
+        bool isOpen()const;                                ///< 出力先が開いているかどうかを返します。
+        void writeStage(int aStageIndex, const Stage& aStage); ///< 終了したステージの指標を書きます。
+
+
+    private:
+        Metrics(const Metrics&);
+        Metrics& operator=(const Metrics&);
+
+        /// ステージの種類ごとの集計
+        struct Rollup {
+            int stageCount;         ///< 終了したステージ数
+            int completeCount;      ///< 配達を完了したステージ数
+            int64_t turns;          ///< ターン数の合計
+            int64_t fuel;           ///< 燃料の合計
+            int64_t score;          ///< 得点の合計
+            double solveSec;        ///< 解答の初期化時間の合計[秒]
+            double maxSolveSec;     ///< 解答の初期化時間の最大値[秒]
+
+            void clear();           ///< 0 にします。
+        };
+
+        void writeHeader();
+        void writeRow(const char* aKind, int aStageIndex, int aCategory, int aWallDensityIndex, int aPeriodSpecifiedIndex, int aItemCountIndex,
+            int aWidth, int aHeight, const Rollup& aRollup);
+
+        std::FILE* mFile;                                   ///< 出力先
+        MetricsFormat mFormat;                              ///< 出力形式
+        Rollup mRollups[LevelDesigner::CategoryCount];      ///< ステージの種類ごとの集計
+    };
+}
+//------------------------------------------------------------------------------
+// EOF
@@ -0,0 +1,259 @@
+//------------------------------------------------------------------------------
+/// @file
+/// @brief HPCPerfCounter.hpp の実装
+/// @author ハル研究所プログラミングコンテスト実行委員会
+///
+/// @copyright  Copyright (c) 2015 HAL Laboratory, Inc.
+/// @attention  このファイルの利用は、同梱のREADMEにある
+///             利用条件に従ってください
+
+//------------------------------------------------------------------------------
+
+#include "HPCPerfCounter.hpp"
+
+#include <chrono>
+#include <cstring>
+#include "HPCCommon.hpp"
+#include "HPCLevelDesigner.hpp"
+
+#if defined(__linux__) && defined(HPC_PERF)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace {
+    using namespace hpc;
+
+    /// カウンタの表示名。
+    const char* const EventNames[PerfEvent_TERM] = {
+        "Cycles",
+        "Instructions",
+        "CacheMisses",
+        "BranchMisses",
+    };
+
+    /// 処理の区分の表示名。
+    const char* const PhaseNames[PerfPhase_TERM] = {
+        "Init",
+        "RunTurn",
+    };
+
+    /// 時間を入れる値の位置。
+    const int TimeValueIndex = PerfEvent_TERM;
+
+    bool sIsEnabled = false;                    ///< 計測が有効か
+    bool sHasCounters = false;                  ///< カウンタが使えるか
+
+    /// [処理の区分][ステージの種類] ごとの区間数と値の合計。
+    int64_t sCalls[PerfPhase_TERM][LevelDesigner::CategoryCount];
+    int64_t sTotals[PerfPhase_TERM][LevelDesigner::CategoryCount][PerfCounter::ValueCount];
+
+    //------------------------------------------------------------------------------
+    /// @return 単調増加する時計の時刻[ナノ秒]。
+    int64_t NowNanoSec()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    // カウンタを開くのは Linux で HPC_PERF を定義したビルド (make PERF=1) だけ。
+#if defined(__linux__) && defined(HPC_PERF)
+    int sFds[PerfEvent_TERM] = { -1, -1, -1, -1 }; ///< カウンタのファイル記述子(先頭がグループの親)
+
+    /// PERF_FORMAT_GROUP で読み出すときの並び。
+    struct GroupReadFormat {
+        uint64_t count;                         ///< カウンタの数
+        uint64_t timeEnabled;                   ///< 有効だった時間
+        uint64_t timeRunning;                   ///< 実際に数えていた時間(多重化されると短くなる)
+        uint64_t values[PerfEvent_TERM];        ///< カウンタの値
+    };
+
+    //------------------------------------------------------------------------------
+    /// 呼び出したスレッドのユーザ空間のイベントを数えるカウンタを 1 つ開きます。
+    ///
+    /// @return ファイル記述子。開けなければ -1 。
+    int OpenCounter(uint32_t aType, uint64_t aConfig, int aGroupFd)
+    {
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = aType;
+        attr.config = aConfig;
+        attr.disabled = aGroupFd == -1 ? 1 : 0;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        return static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, aGroupFd, 0));
+    }
+
+    //------------------------------------------------------------------------------
+    /// カウンタのグループを開いて数え始めます。1 つでも開けなければ全部閉じます。
+    ///
+    /// @return 開けたら @c true 。
+    bool OpenCounters()
+    {
+        const uint64_t configs[PerfEvent_TERM] = {
+            PERF_COUNT_HW_CPU_CYCLES,
+            PERF_COUNT_HW_INSTRUCTIONS,
+            PERF_COUNT_HW_CACHE_MISSES,
+            PERF_COUNT_HW_BRANCH_MISSES,
+        };
+        for (int i = 0; i < PerfEvent_TERM; ++i) {
+            sFds[i] = OpenCounter(PERF_TYPE_HARDWARE, configs[i], i == 0 ? -1 : sFds[0]);
+            if (sFds[i] == -1) {
+                for (int j = 0; j < i; ++j) {
+                    close(sFds[j]);
+                    sFds[j] = -1;
+                }
+                return false;
+            }
+        }
+        ioctl(sFds[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+        ioctl(sFds[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+        return true;
+    }
+
+    //------------------------------------------------------------------------------
+    /// カウンタの値を読みます。多重化で数えていない時間があれば、その分を補います。
+    ///
+    /// @param[out] aValues カウンタの値。
+    void ReadCounters(int64_t* aValues)
+    {
+        GroupReadFormat format;
+        if (read(sFds[0], &format, sizeof(format)) != static_cast<ssize_t>(sizeof(format)) || format.timeRunning == 0) {
+            for (int i = 0; i < PerfEvent_TERM; ++i) {
+                aValues[i] = 0;
+            }
+            return;
+        }
+        const double scale = static_cast<double>(format.timeEnabled) / format.timeRunning;
+        for (int i = 0; i < PerfEvent_TERM; ++i) {
+            aValues[i] = static_cast<int64_t>(format.values[i] * scale);
+        }
+    }
+#else
+    bool OpenCounters()
+    {
+        return false;
+    }
+
+    void ReadCounters(int64_t* aValues)
+    {
+        for (int i = 0; i < PerfEvent_TERM; ++i) {
+            aValues[i] = 0;
+        }
+    }
+#endif
+}
+
+namespace hpc {
+
+    //------------------------------------------------------------------------------
+    /// 計測を有効にし、カウンタを開きます。
+    ///
+    /// カウンタは呼び出したスレッドのものなので、計測する処理を実行するスレッドから呼んでください。
+    /// HPC_PERF を定義しないビルドでは計測しないので、カウンタは開きません(OpenCounters が何もしません)。
+    void PerfCounter::Enable()
+    {
+        if (sIsEnabled) {
+            return;
+        }
+        sIsEnabled = true;
+        sHasCounters = OpenCounters();
+    }
+
+    //------------------------------------------------------------------------------
+    /// @return Enable を呼んでいれば @c true 。
+    bool PerfCounter::IsEnabled()
+    {
+        return sIsEnabled;
+    }
+
+    //------------------------------------------------------------------------------
+    /// @return カウンタを開けていれば @c true 。 @c false なら時間だけを集計しています。
+    bool PerfCounter::HasCounters()
+    {
+        return sHasCounters;
+    }
+
+    //------------------------------------------------------------------------------
+    /// 区間の開始時の値を読みます。
+    ///
+    /// @param[out] aValues カウンタと時間の値。 ValueCount 個。
+    void PerfCounter::Begin(int64_t* aValues)
+    {
+        if (sHasCounters) {
+            ReadCounters(aValues);
+        }
+        aValues[TimeValueIndex] = NowNanoSec();
+    }
+
+    //------------------------------------------------------------------------------
+    /// 区間の終了時の値を読み、開始時との差を集計します。
+    ///
+    /// @param[in] aPhase 処理の区分。
+    /// @param[in] aStageIndex ステージ番号。
+    /// @param[in] aBeginValues Begin で読んだ値。
+    void PerfCounter::End(PerfPhase aPhase, int aStageIndex, const int64_t* aBeginValues)
+    {
+        int64_t values[ValueCount];
+        values[TimeValueIndex] = NowNanoSec();
+        if (sHasCounters) {
+            ReadCounters(values);
+        }
+        const int category = LevelDesigner::Category(aStageIndex);
+        ++sCalls[aPhase][category];
+        for (int i = 0; i < ValueCount; ++i) {
+            if (i == TimeValueIndex || sHasCounters) {
+                sTotals[aPhase][category][i] += values[i] - aBeginValues[i];
+            }
+        }
+    }
+
+    //------------------------------------------------------------------------------
+    /// 集計結果を表示します。
+    ///
+    /// 処理の区分ごとに、ステージの種類別の合計と IPC (命令数 / サイクル) を出します。
+    void PerfCounter::Print()
+    {
+        if (!sIsEnabled) {
+            return;
+        }
+#ifndef HPC_PERF
+        HPC_PRINT("Hardware counters are not measured. Rebuild with 'make clean && make PERF=1'.\n");
+        return;
+#endif
+        if (!sHasCounters) {
+            HPC_PRINT("Hardware counters are not available (perf_event_open failed). Showing time only.\n");
+        }
+        HPC_PRINT("%-22s %9s %10s", "Phase / Category", "Calls", "Time[ms]");
+        if (sHasCounters) {
+            for (int i = 0; i < PerfEvent_TERM; ++i) {
+                HPC_PRINT(" %14s", EventNames[i]);
+            }
+            HPC_PRINT(" %6s", "IPC");
+        }
+        HPC_PRINT("\n");
+        for (int phase = 0; phase < PerfPhase_TERM; ++phase) {
+            HPC_PRINT("%s\n", PhaseNames[phase]);
+            for (int category = 0; category < LevelDesigner::CategoryCount; ++category) {
+                const int64_t* totals = sTotals[phase][category];
+                if (sCalls[phase][category] == 0) {
+                    continue;
+                }
+                HPC_PRINT("  %-20s %9lld %10.3f", LevelDesigner::CategoryLabel(category),
+                    static_cast<long long>(sCalls[phase][category]), totals[TimeValueIndex] / 1e6);
+                if (sHasCounters) {
+                    for (int i = 0; i < PerfEvent_TERM; ++i) {
+                        HPC_PRINT(" %14lld", static_cast<long long>(totals[i]));
+                    }
+                    HPC_PRINT(" %6.2f", totals[PerfEvent_Cycles] == 0 ? 0.0 : static_cast<double>(totals[PerfEvent_Instructions]) / totals[PerfEvent_Cycles]);
+                }
+                HPC_PRINT("\n");
+            }
+        }
+    }
+}
+//------------------------------------------------------------------------------
+// EOF
@@ -0,0 +1,106 @@
+//------------------------------------------------------------------------------
+/// @file
+/// @brief PerfCounter クラス
+/// @author ハル研究所プログラミングコンテスト実行委員会
+///
+/// @copyright  Copyright (c) 2015 HAL Laboratory, Inc.
+/// @attention  このファイルの利用は、同梱のREADMEにある
+///             利用条件に従ってください
+
+//------------------------------------------------------------------------------
+#pragma once
+
+#include <cstdint>
+
+namespace hpc {
+
+    //------------------------------------------------------------------------------
+    /// ハードウェアカウンタで数えるイベントを表します。
+    enum PerfEvent {
+        PerfEvent_Cycles,           ///< CPU サイクル
+        PerfEvent_Instructions,     ///< 実行した命令
+        PerfEvent_CacheMisses,      ///< 最終レベルキャッシュのミス
+        PerfEvent_BranchMisses,     ///< 分岐予測ミス
+        PerfEvent_TERM
+    };
+
+    //------------------------------------------------------------------------------
+    /// カウンタで計測する処理の区分を表します。
+    enum PerfPhase {
+        PerfPhase_Init,             ///< Answer::Init (経路探索と計画)
+        PerfPhase_RunTurn,          ///< Stage::runTurn (シミュレーション)
+        PerfPhase_TERM
+    };
+
+    //------------------------------------------------------------------------------
+    /// 処理の区分ごとに、ハードウェアカウンタの値をステージの種類別に集計します。
+    ///
+    /// Linux の perf_event_open で、呼び出したスレッドのカウンタをグループとして開きます。
+    /// 開けない環境(権限のないコンテナや Linux 以外)では、時間だけを集計します。
+    ///
+    /// 計測は HPC_PERF を定義してビルドしたとき (make PERF=1) だけ行われます。
+    /// 定義しなければ HPC_PERF_SCOPE は何も生成しません。
+    class PerfCounter
+    {
+    public:
+        static void Enable();                               ///< 計測を有効にし、カウンタを開きます。
+        static bool IsEnabled();                            ///< 計測が有効かどうかを返します。
+        static bool HasCounters();                          ///< カウンタが使えるかどうかを返します。
+        static void Print();                                ///< 集計結果を表示します。
+
+        static void Begin(int64_t* aValues);                ///< 区間の開始時の値を読みます。
+        static void End(PerfPhase aPhase, int aStageIndex, const int64_t* aBeginValues); ///< 区間の終了時の値を読み、差を集計します。
+
+        static const int ValueCount = PerfEvent_TERM + 1;   ///< 読む値の数(カウンタと時間[ナノ秒])
+
+    private:
+        PerfCounter();
+    };
+
+    //------------------------------------------------------------------------------
+    /// 生成から破棄までのカウンタの差を PerfCounter に集計します。計測が無効なら何もしません。
+    class PerfScope
+    {
+    public:
+        PerfScope(PerfPhase aPhase, int aStageIndex)
+            : mPhase(aPhase)
+            , mStageIndex(aStageIndex)
+            , mIsEnabled(PerfCounter::IsEnabled())
+        {
+            if (mIsEnabled) {
+                PerfCounter::Begin(mBeginValues);
+            }
+        }
+
+        ~PerfScope()
+        {
+            if (mIsEnabled) {
+                PerfCounter::End(mPhase, mStageIndex, mBeginValues);
+            }
+        }
+
+    private:
+        PerfScope(const PerfScope&);
+        PerfScope& operator=(const PerfScope&);
+
+        const PerfPhase mPhase;                         ///< 処理の区分
+        const int mStageIndex;                          ///< ステージ番号
+        const bool mIsEnabled;                          ///< 計測するか
+        int64_t mBeginValues[PerfCounter::ValueCount];  ///< 開始時の値
+    };
+}
+
+//------------------------------------------------------------------------------
+/// スコープの終わりまでのカウンタの差を集計します。
+/// HPC_PERF を定義しないときは何も生成しません。
+#define HPC_PERF_CONCAT_IMPL(a, b) a##b
+#define HPC_PERF_CONCAT(a, b) HPC_PERF_CONCAT_IMPL(a, b)
+
+#ifdef HPC_PERF
+#define HPC_PERF_SCOPE(aPhase, aStageIndex) \
+    ::hpc::PerfScope HPC_PERF_CONCAT(hpcPerfScope, __LINE__)(aPhase, aStageIndex)
+#else
+#define HPC_PERF_SCOPE(aPhase, aStageIndex) do {} while (false)
+#endif
+//------------------------------------------------------------------------------
+// EOF
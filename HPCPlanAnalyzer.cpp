@@ -0,0 +1,366 @@
+//------------------------------------------------------------------------------
+/// @file
+/// @brief HPCPlanAnalyzer.hpp の実装
+/// @author ハル研究所プログラミングコンテスト実行委員会
+///
+/// @copyright  Copyright (c) 2015 HAL Laboratory, Inc.
+/// @attention  このファイルの利用は、同梱のREADMEにある
+///             利用条件に従ってください
+
+//------------------------------------------------------------------------------
+
+#include "HPCPlanAnalyzer.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include "HPCCommon.hpp"
+#include "HPCStage.hpp"
+
+namespace {
+    using namespace hpc;
+
+    /// 営業所の地点番号。
+    const int OfficePoint = Parameter::ItemCountMax;
+
+    /// 幅優先探索で使う移動。
+    const Action Moves[] = {
+        Action_MoveLeft,
+        Action_MoveRight,
+        Action_MoveDown,
+        Action_MoveUp,
+    };
+
+    //------------------------------------------------------------------------------
+    /// @return 割合[%]。分母が 0 なら 0 。
+    double Percent(int64_t aValue, int64_t aTotal)
+    {
+        return aTotal == 0 ? 0.0 : 100.0 * aValue / aTotal;
+    }
+}
+
+namespace hpc {
+
+    //------------------------------------------------------------------------------
+    /// PlanAnalyzer クラスのインスタンスを生成します。
+    PlanAnalyzer::PlanAnalyzer()
+        : mIsEnabled(false)
+        , mWidth(0)
+        , mPointCells()
+        , mDistance()
+        , mPrevResult()
+        , mTurns(0)
+        , mLegStartPos()
+        , mLegMoves(0)
+        , mLegBumps(0)
+        , mOrder()
+        , mOrderCount(0)
+        , mPeriodFuel(0)
+        , mStageRollup()
+        , mRollups()
+    {
+    }
+
+    //------------------------------------------------------------------------------
+    /// 集計を有効にします。ステージを始める前に呼んでください。
+    void PlanAnalyzer::enable()
+    {
+        mIsEnabled = true;
+    }
+
+    //------------------------------------------------------------------------------
+    /// @return enable を呼んでいれば @c true 。
+    bool PlanAnalyzer::isEnabled()const
+    {
+        return mIsEnabled;
+    }
+
+    //------------------------------------------------------------------------------
+    /// 開始したステージの、営業所と各配達先への最短距離を求めます。
+    ///
+    /// @param[in] aStage 開始したステージ。 Stage::start の後に呼んでください。
+    void PlanAnalyzer::startStage(const Stage& aStage)
+    {
+        if (!mIsEnabled) {
+            return;
+        }
+        mWidth = aStage.field().width();
+        for (int i = 0; i < aStage.items().count(); ++i) {
+            computeDistance(aStage, i, aStage.items()[i].destination());
+        }
+        computeDistance(aStage, OfficePoint, aStage.field().officePos());
+
+        std::memset(&mStageRollup, 0, sizeof(mStageRollup));
+        mPrevResult.set(aStage.lastTurnResult());
+        mTurns = 0;
+        mOrderCount = 0;
+        mPeriodFuel = 0;
+    }
+
+    //------------------------------------------------------------------------------
+    /// 実行したターンを調べます。
+    ///
+    /// @param[in] aStage  実行中のステージ。
+    /// @param[in] aResult Stage::runTurn で進めたターンの結果。
+    void PlanAnalyzer::addTurn(const Stage& aStage, const TurnResult& aResult)
+    {
+        if (!mIsEnabled) {
+            return;
+        }
+        ++mTurns;
+        if (aResult.initPeriod) {
+            // 積み込み。営業所から最初の区間を始める。
+            mOrderCount = 0;
+            mPeriodFuel = 0;
+            mLegStartPos = aResult.truckPos;
+            mLegMoves = 0;
+            mLegBumps = 0;
+            mPrevResult.set(aResult);
+            return;
+        }
+
+        // 移動。全ての行動は移動なので、位置が変わらなければ壁にぶつかっている。
+        const int cost = aResult.periodCost - mPrevResult.periodCost;
+        mStageRollup.fuel += cost;
+        mPeriodFuel += cost;
+        ++mLegMoves;
+        if (aResult.truckPos == mPrevResult.truckPos) {
+            ++mLegBumps;
+            ++mStageRollup.wallBumps;
+            mStageRollup.wallBumpFuel += cost;
+        }
+
+        // 届けた荷物ごとに区間を閉じる。同じターンに 2 つ目以降を届けた区間は長さ 0 になる。
+        for (int i = 0; i < aStage.items().count(); ++i) {
+            if (mPrevResult.itemGroup.hasItem(i) && !aResult.itemGroup.hasItem(i)) {
+                closeLeg(i);
+                mOrder[mOrderCount++] = i;
+            }
+        }
+        if (!aResult.itemGroup.hasAnyItems() && aResult.truckPos == aStage.field().officePos()) {
+            closeLeg(OfficePoint);
+            closePeriod(aStage);
+        }
+        mPrevResult.set(aResult);
+    }
+
+    //------------------------------------------------------------------------------
+    /// 終了したステージを、ステージの種類ごとの集計に加えます。
+    ///
+    /// @param[in] aStageIndex ステージ番号。
+    /// @param[in] aStage      終了したステージ。
+    void PlanAnalyzer::endStage(int aStageIndex, const Stage& aStage)
+    {
+        if (!mIsEnabled) {
+            return;
+        }
+        Rollup& rollup = mRollups[LevelDesigner::Category(aStageIndex)];
+        ++rollup.stageCount;
+        if (aStage.lastTurnResult().state == StageState_TurnLimit) {
+            ++rollup.turnLimitCount;
+        }
+        rollup.turns += mTurns;
+        rollup.maxTurns = std::max(rollup.maxTurns, mTurns);
+        rollup.fuel += mStageRollup.fuel;
+        rollup.wallBumps += mStageRollup.wallBumps;
+        rollup.wallBumpFuel += mStageRollup.wallBumpFuel;
+        rollup.detourMoves += mStageRollup.detourMoves;
+        rollup.routeExcessFuel += mStageRollup.routeExcessFuel;
+        rollup.orderExcessFuel += mStageRollup.orderExcessFuel;
+    }
+
+    //------------------------------------------------------------------------------
+    /// 集計結果をステージの種類ごとに表示します。
+    ///
+    /// Leak は、最短経路と局所探索の配達順で回ったときより多く消費した燃料の割合です。
+    void PlanAnalyzer::print()const
+    {
+        if (!mIsEnabled) {
+            return;
+        }
+        HPC_PRINT("%-20s %6s %8s %6s %5s %7s %9s %7s %10s %10s %10s %6s\n",
+            "Category", "Stages", "Turns", "Max", "Limit", "Bumps", "BumpFuel", "Detour", "RouteFuel", "OrderFuel", "Fuel", "Leak%");
+        Rollup total;
+        std::memset(&total, 0, sizeof(total));
+        for (int category = 0; category <= LevelDesigner::CategoryCount; ++category) {
+            const bool isTotal = category == LevelDesigner::CategoryCount;
+            const Rollup& rollup = isTotal ? total : mRollups[category];
+            if (rollup.stageCount == 0) {
+                continue;
+            }
+            HPC_PRINT("%-20s %6d %8.1f %6d %5d %7lld %9lld %7lld %10lld %10lld %10lld %6.2f\n",
+                isTotal ? "total" : LevelDesigner::CategoryLabel(category),
+                rollup.stageCount, static_cast<double>(rollup.turns) / rollup.stageCount, rollup.maxTurns, rollup.turnLimitCount,
+                static_cast<long long>(rollup.wallBumps), static_cast<long long>(rollup.wallBumpFuel),
+                static_cast<long long>(rollup.detourMoves), static_cast<long long>(rollup.routeExcessFuel),
+                static_cast<long long>(rollup.orderExcessFuel), static_cast<long long>(rollup.fuel),
+                Percent(rollup.routeExcessFuel + rollup.orderExcessFuel, rollup.fuel));
+            if (!isTotal) {
+                total.stageCount += rollup.stageCount;
+                total.turnLimitCount += rollup.turnLimitCount;
+                total.turns += rollup.turns;
+                total.maxTurns = std::max(total.maxTurns, rollup.maxTurns);
+                total.fuel += rollup.fuel;
+                total.wallBumps += rollup.wallBumps;
+                total.wallBumpFuel += rollup.wallBumpFuel;
+                total.detourMoves += rollup.detourMoves;
+                total.routeExcessFuel += rollup.routeExcessFuel;
+                total.orderExcessFuel += rollup.orderExcessFuel;
+            }
+        }
+        HPC_PRINT("Turn limit per stage: %d\n", Parameter::GameTurnPerStage);
+    }
+
+    //------------------------------------------------------------------------------
+    /// 幅優先探索で、位置までの各マスからの最短距離を求めます。
+    ///
+    /// @param[in]  aField    対象のフィールド。
+    /// @param[in]  aPos      目的の位置。
+    /// @param[out] aDistance [y * 幅 + x] の最短距離。行けないマスは -1 。
+    void PlanAnalyzer::ComputeDistanceMap(const Field& aField, const Pos& aPos, int* aDistance)
+    {
+        const int width = aField.width();
+        std::fill(aDistance, aDistance + width * aField.height(), -1);
+
+        Pos queue[Parameter::FieldHeightMax * Parameter::FieldWidthMax];
+        int head = 0;
+        int tail = 0;
+        aDistance[aPos.y * width + aPos.x] = 0;
+        queue[tail++] = aPos;
+        while (head < tail) {
+            const Pos pos = queue[head++];
+            const int nextDistance = aDistance[pos.y * width + pos.x] + 1;
+            for (int i = 0; i < static_cast<int>(sizeof(Moves) / sizeof(Moves[0])); ++i) {
+                const Pos next = pos.move(Moves[i]);
+                if (next.x < 0 || width <= next.x || next.y < 0 || aField.height() <= next.y || aField.isWall(next)) {
+                    continue;
+                }
+                int& nextCell = aDistance[next.y * width + next.x];
+                if (nextCell == -1) {
+                    nextCell = nextDistance;
+                    queue[tail++] = next;
+                }
+            }
+        }
+    }
+
+    //------------------------------------------------------------------------------
+    /// 地点までの各マスからの最短距離を求めます。
+    ///
+    /// @param[in] aStage 対象のステージ。
+    /// @param[in] aPoint 地点の番号。
+    /// @param[in] aPos   地点の位置。
+    void PlanAnalyzer::computeDistance(const Stage& aStage, int aPoint, const Pos& aPos)
+    {
+        HPC_RANGE_ASSERT_MIN_UB_I(aPoint, 0, PointCount);
+        mPointCells[aPoint] = aPos.y * mWidth + aPos.x;
+        ComputeDistanceMap(aStage.field(), aPos, mDistance[aPoint]);
+    }
+
+    //------------------------------------------------------------------------------
+    /// @return 地点から地点への最短距離。
+    int PlanAnalyzer::distance(int aFromPoint, int aToPoint)const
+    {
+        return mDistance[aToPoint][mPointCells[aFromPoint]];
+    }
+
+    //------------------------------------------------------------------------------
+    /// @return 位置から地点への最短距離。
+    int PlanAnalyzer::distanceFrom(const Pos& aFrom, int aToPoint)const
+    {
+        return mDistance[aToPoint][aFrom.y * mWidth + aFrom.x];
+    }
+
+    //------------------------------------------------------------------------------
+    /// 営業所から配達順に荷物を届けて戻るまでを、最短経路で回ったときの燃料を返します。
+    ///
+    /// @param[in] aStage 対象のステージ。
+    /// @param[in] aOrder 配達順の荷物。
+    /// @param[in] aCount 荷物の数。
+    ///
+    /// @return 燃料。
+    int PlanAnalyzer::orderFuel(const Stage& aStage, const int* aOrder, int aCount)const
+    {
+        int weight = Parameter::TruckWeight;
+        for (int i = 0; i < aCount; ++i) {
+            weight += aStage.items()[aOrder[i]].weight();
+        }
+        int fuel = 0;
+        int point = OfficePoint;
+        for (int i = 0; i < aCount; ++i) {
+            fuel += distance(point, aOrder[i]) * weight;
+            weight -= aStage.items()[aOrder[i]].weight();
+            point = aOrder[i];
+        }
+        return fuel + distance(point, OfficePoint) * weight;
+    }
+
+    //------------------------------------------------------------------------------
+    /// 配達順から荷物を 1 つ抜いて別の位置に入れる局所探索を、改善しなくなるまで繰り返します。
+    ///
+    /// @param[in] aStage 対象のステージ。
+    /// @param[in] aOrder 元の配達順の荷物。
+    /// @param[in] aCount 荷物の数。
+    ///
+    /// @return 見つけた配達順を最短経路で回ったときの燃料。
+    int PlanAnalyzer::bestOrderFuel(const Stage& aStage, const int* aOrder, int aCount)const
+    {
+        int order[Parameter::ItemCountMax];
+        std::copy(aOrder, aOrder + aCount, order);
+        int bestFuel = orderFuel(aStage, order, aCount);
+        bool isImproved = true;
+        while (isImproved) {
+            isImproved = false;
+            for (int from = 0; from < aCount; ++from) {
+                for (int to = 0; to < aCount; ++to) {
+                    if (from == to) {
+                        continue;
+                    }
+                    int candidate[Parameter::ItemCountMax];
+                    std::copy(order, order + aCount, candidate);
+                    if (from < to) {
+                        std::rotate(candidate + from, candidate + from + 1, candidate + to + 1);
+                    } else {
+                        std::rotate(candidate + to, candidate + from, candidate + from + 1);
+                    }
+                    const int fuel = orderFuel(aStage, candidate, aCount);
+                    if (fuel < bestFuel) {
+                        bestFuel = fuel;
+                        std::copy(candidate, candidate + aCount, order);
+                        isImproved = true;
+                    }
+                }
+            }
+        }
+        return bestFuel;
+    }
+
+    //------------------------------------------------------------------------------
+    /// 地点に着いた区間を閉じ、最短経路より多く動いた手を数えて、次の区間を始めます。
+    ///
+    /// @param[in] aToPoint 着いた地点の番号。
+    void PlanAnalyzer::closeLeg(int aToPoint)
+    {
+        const int shortest = distanceFrom(mLegStartPos, aToPoint);
+        if (shortest >= 0) {
+            mStageRollup.detourMoves += mLegMoves - mLegBumps - shortest;
+        }
+        mLegStartPos = Pos(mPointCells[aToPoint] % mWidth, mPointCells[aToPoint] / mWidth);
+        mLegMoves = 0;
+        mLegBumps = 0;
+    }
+
+    //------------------------------------------------------------------------------
+    /// 営業所に戻った時間帯の燃料を、最短経路と局所探索の配達順で回ったときの燃料と比べます。
+    ///
+    /// @param[in] aStage 対象のステージ。
+    void PlanAnalyzer::closePeriod(const Stage& aStage)
+    {
+        const int fuel = orderFuel(aStage, mOrder, mOrderCount);
+        mStageRollup.routeExcessFuel += mPeriodFuel - fuel;
+        mStageRollup.orderExcessFuel += fuel - bestOrderFuel(aStage, mOrder, mOrderCount);
+        mOrderCount = 0;
+        mPeriodFuel = 0;
+    }
+}
+//------------------------------------------------------------------------------
+// EOF
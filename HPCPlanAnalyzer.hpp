@@ -0,0 +1,92 @@
+//------------------------------------------------------------------------------
+/// @file
+/// @brief PlanAnalyzer クラス
+/// @author ハル研究所プログラミングコンテスト実行委員会
+///
+/// @copyright  Copyright (c) 2015 HAL Laboratory, Inc.
+/// @attention  このファイルの利用は、同梱のREADMEにある
+///             利用条件に従ってください
+
+//------------------------------------------------------------------------------
+#pragma once
+
+#include <cstdint>
+#include "HPCLevelDesigner.hpp"
+#include "HPCParameter.hpp"
+#include "HPCPos.hpp"
+#include "HPCTurnResult.hpp"
+
+namespace hpc {
+    class Field;
+    class Stage;
+
+    //------------------------------------------------------------------------------
+    /// 実行された計画を調べ、無駄に使った燃料をステージの種類ごとに集計します。
+    ///
+    /// 荷物を届けるか営業所に戻るまでの移動を 1 区間とし、区間ごとに次を数えます。
+    /// - 壁にぶつかって動けなかった手 (燃料だけ消費する)
+    /// - 最短経路より多く動いた手
+    /// - 実際に消費した燃料と、同じ配達順を最短経路で回ったときの燃料の差
+    ///
+    /// さらに時間帯ごとに、配達順を 1 つ動かす局所探索で見つけた順序との燃料の差と、
+    /// ステージごとのターン数を Parameter::GameTurnPerStage と比べて集計します。
+    class PlanAnalyzer
+    {
+    public:
+        PlanAnalyzer();
+
+        void enable();                                      ///< 集計を有効にします。
+        bool isEnabled()const;                             ///< 集計が有効かどうかを返します。
+        void startStage(const Stage& aStage);               ///< 開始したステージの最短距離を求めます。
+        void addTurn(const Stage& aStage, const TurnResult& aResult); ///< 実行したターンを調べます。
+        void endStage(int aStageIndex, const Stage& aStage); ///< 終了したステージを集計します。
+        void print()const;                                 ///< 集計結果を表示します。
+
+        static void ComputeDistanceMap(const Field& aField, const Pos& aPos, int* aDistance); ///< 各マスからの最短距離を求めます。
+
+    private:
+        /// ステージの種類ごとの集計
+        struct Rollup {
+            int stageCount;         ///< 終了したステージ数
+            int turnLimitCount;     ///< ターン数の上限に達したステージ数
+            int64_t turns;          ///< ターン数の合計
+            int maxTurns;           ///< ターン数の最大値
+            int64_t fuel;           ///< 燃料の合計
+            int64_t wallBumps;      ///< 壁にぶつかった手の数
+            int64_t wallBumpFuel;   ///< 壁にぶつかった手で消費した燃料
+            int64_t detourMoves;    ///< 最短経路より多く動いた手の数(壁にぶつかった手を除く)
+            int64_t routeExcessFuel; ///< 同じ配達順を最短経路で回ったときより多く消費した燃料
+            int64_t orderExcessFuel; ///< 局所探索で見つけた配達順より多く消費する燃料(最短経路で比べる)
+        };
+
+        /// 地点の番号。荷物の番号と同じで、営業所は最後。
+        static const int PointCount = Parameter::ItemCountMax + 1;
+
+        void computeDistance(const Stage& aStage, int aPoint, const Pos& aPos);
+        int distance(int aFromPoint, int aToPoint)const;
+        int distanceFrom(const Pos& aFrom, int aToPoint)const;
+        int orderFuel(const Stage& aStage, const int* aOrder, int aCount)const;
+        int bestOrderFuel(const Stage& aStage, const int* aOrder, int aCount)const;
+        void closeLeg(int aToPoint);
+        void closePeriod(const Stage& aStage);
+
+        bool mIsEnabled;                                    ///< 集計するか
+        int mWidth;                                         ///< フィールドの幅
+        int mPointCells[PointCount];                        ///< [地点] 地点のマスの番号
+        int mDistance[PointCount][Parameter::FieldHeightMax * Parameter::FieldWidthMax]; ///< [地点][マス] 地点までの最短距離。行けなければ -1
+
+        TurnResult mPrevResult;                             ///< 直前のターンの結果
+        int mTurns;                                         ///< このステージのターン数
+        Pos mLegStartPos;                                   ///< 区間の開始位置
+        int mLegMoves;                                      ///< 区間の手数
+        int mLegBumps;                                      ///< 区間で壁にぶつかった手数
+        int mOrder[Parameter::ItemCountMax];                ///< この時間帯に届けた順の荷物
+        int mOrderCount;                                    ///< この時間帯に届けた荷物の数
+        int mPeriodFuel;                                    ///< この時間帯に消費した燃料
+
+        Rollup mStageRollup;                                ///< このステージの集計
+        Rollup mRollups[LevelDesigner::CategoryCount];      ///< ステージの種類ごとの集計
+    };
+}
+//------------------------------------------------------------------------------
+// EOF
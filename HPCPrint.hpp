@@ -18,6 +18,13 @@
 #define HPC_PRINT(...) \
     do { std::printf(__VA_ARGS__); } while (false)
 
+/// 文字列をファイルに出力します。
+///
+/// @param[in] file 出力先の std::FILE* 。
+/// @param[in] ... 書式つき文字列とデータ。 std::printf の記法に準拠します。
+#define HPC_FPRINT(file, ...) \
+    do { std::fprintf(file, __VA_ARGS__); } while (false)
+
 /// 項目を付加して画面に文字列を表示します。　
 ///
 /// @param[in] category  項目名。6文字以内。
@@ -0,0 +1,166 @@
+//------------------------------------------------------------------------------
+/// @file
+/// @brief HPCProfiler.hpp の実装
+/// @author ハル研究所プログラミングコンテスト実行委員会
+///
+/// @copyright  Copyright (c) 2015 HAL Laboratory, Inc.
+/// @attention  このファイルの利用は、同梱のREADMEにある
+///             利用条件に従ってください
+
+//------------------------------------------------------------------------------
+
+#include "HPCProfiler.hpp"
+
+#include <chrono>
+#include "HPCCommon.hpp"
+#include "HPCHistogram.hpp"
+#include "HPCLevelDesigner.hpp"
+
+namespace {
+    using namespace hpc;
+
+    /// 処理の区分の表示名。
+    const char* const PhaseNames[ProfilePhase_TERM] = {
+        "Setup",
+        "Init",
+        "InitPeriod",
+        "GetNextAction",
+        "RunTurn",
+        "RecordWrite",
+        "OutputJson",
+    };
+
+    /// [処理の区分][ステージの種類] ごとの所要時間[ナノ秒]。
+    Histogram sHistograms[ProfilePhase_TERM][LevelDesigner::CategoryCount];
+
+    /// 現在のステージの種類。ステージの外の処理(JSON の出力など)は最後のステージに含めます。
+    int sCategory = 0;
+
+    //------------------------------------------------------------------------------
+    /// ヒストグラムの要約を 1 行表示します。
+    ///
+    /// @param[in] aLabel 行の見出し。
+    /// @param[in] aHistogram 表示するヒストグラム。
+    void PrintRow(const char* aLabel, const Histogram& aHistogram)
+    {
+        HPC_PRINT("  %-20s %9lld %12.3f %10.3f %10.3f %10.3f\n", aLabel,
+            static_cast<long long>(aHistogram.count()),
+            aHistogram.sum() / 1e6,
+            aHistogram.percentile(50) / 1e3,
+            aHistogram.percentile(99) / 1e3,
+            aHistogram.max() / 1e3);
+    }
+}
+
+namespace hpc {
+
+    //------------------------------------------------------------------------------
+    /// @return HPC_PROFILE を定義してビルドした場合は @c true 。
+    bool Profiler::IsEnabled()
+    {
+#ifdef HPC_PROFILE
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    //------------------------------------------------------------------------------
+    /// 以降の計測を集計するステージを設定します。
+    ///
+    /// @param[in] aStageIndex ステージ番号。
+    void Profiler::SetStage(int aStageIndex)
+    {
+        sCategory = LevelDesigner::Category(aStageIndex);
+    }
+
+    //------------------------------------------------------------------------------
+    /// 所要時間を 1 つ記録します。
+    ///
+    /// @param[in] aPhase 処理の区分。
+    /// @param[in] aNanoSec 所要時間[ナノ秒]。
+    void Profiler::Add(ProfilePhase aPhase, int64_t aNanoSec)
+    {
+        HPC_RANGE_ASSERT_MIN_UB_I(aPhase, 0, ProfilePhase_TERM);
+        sHistograms[aPhase][sCategory].add(aNanoSec);
+    }
+
+    //------------------------------------------------------------------------------
+    /// 計測に使う現在時刻を返します。
+    ///
+    /// @return 単調増加する時計の時刻[ナノ秒]。
+    int64_t Profiler::NowNanoSec()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    //------------------------------------------------------------------------------
+    /// 集計結果を表示します。
+    ///
+    /// 処理の区分ごとに全体の行を出し、続けてステージの種類ごとの行を出します。
+    /// 区分は入れ子になるため、合計を足し合わせても全体の時間にはなりません。
+    void Profiler::Print()
+    {
+        if (!IsEnabled()) {
+            HPC_PRINT("Profiler is disabled. Rebuild with 'make clean && make PROFILE=1'.\n");
+            return;
+        }
+        HPC_PRINT("%-22s %9s %12s %10s %10s %10s\n", "Phase / Category", "Count", "Total[ms]", "p50[us]", "p99[us]", "Max[us]");
+        for (int phase = 0; phase < ProfilePhase_TERM; ++phase) {
+            Histogram total;
+            for (int category = 0; category < LevelDesigner::CategoryCount; ++category) {
+                total.merge(sHistograms[phase][category]);
+            }
+            if (total.count() == 0) {
+                continue;
+            }
+            HPC_PRINT("%s\n", PhaseNames[phase]);
+            PrintRow("(all)", total);
+            for (int category = 0; category < LevelDesigner::CategoryCount; ++category) {
+                if (sHistograms[phase][category].count() != 0) {
+                    PrintRow(LevelDesigner::CategoryLabel(category), sHistograms[phase][category]);
+                }
+            }
+        }
+    }
+
+    //------------------------------------------------------------------------------
+    /// 集計を消去します。1 つのプロセスでゲームを繰り返し実行するときに、実行ごとに呼びます。
+    void Profiler::Reset()
+    {
+        for (int phase = 0; phase < ProfilePhase_TERM; ++phase) {
+            for (int category = 0; category < LevelDesigner::CategoryCount; ++category) {
+                sHistograms[phase][category].clear();
+            }
+        }
+        sCategory = 0;
+    }
+
+    //------------------------------------------------------------------------------
+    /// 処理の区分の所要時間を、全てのステージの種類について合計します。
+    ///
+    /// @param[in] aPhase 処理の区分。
+    ///
+    /// @return 所要時間の合計[ナノ秒]。計測が無効なビルドでは 0 。
+    int64_t Profiler::TotalNanoSec(ProfilePhase aPhase)
+    {
+        HPC_RANGE_ASSERT_MIN_UB_I(aPhase, 0, ProfilePhase_TERM);
+        int64_t total = 0;
+        for (int category = 0; category < LevelDesigner::CategoryCount; ++category) {
+            total += sHistograms[aPhase][category].sum();
+        }
+        return total;
+    }
+
+    //------------------------------------------------------------------------------
+    /// @param[in] aPhase 処理の区分。
+    ///
+    /// @return 処理の区分の名前。
+    const char* Profiler::PhaseName(ProfilePhase aPhase)
+    {
+        HPC_RANGE_ASSERT_MIN_UB_I(aPhase, 0, ProfilePhase_TERM);
+        return PhaseNames[aPhase];
+    }
+}
+//------------------------------------------------------------------------------
+// EOF
@@ -0,0 +1,93 @@
+//------------------------------------------------------------------------------
+/// @file
+/// @brief Profiler クラス
+/// @author ハル研究所プログラミングコンテスト実行委員会
+///
+/// @copyright  Copyright (c) 2015 HAL Laboratory, Inc.
+/// @attention  このファイルの利用は、同梱のREADMEにある
+///             利用条件に従ってください
+
+//------------------------------------------------------------------------------
+#pragma once
+
+#include <cstdint>
+
+namespace hpc {
+
+    //------------------------------------------------------------------------------
+    /// 計測する処理の区分を表します。
+    ///
+    /// 区分は入れ子になることがあります(RunTurn は InitPeriod と GetNextAction を含みます)。
+    enum ProfilePhase {
+        ProfilePhase_Setup,             ///< LevelDesigner::Setup
+        ProfilePhase_Init,              ///< Answer::Init
+        ProfilePhase_InitPeriod,        ///< Answer::InitPeriod
+        ProfilePhase_GetNextAction,     ///< Answer::GetNextAction
+        ProfilePhase_RunTurn,           ///< Stage::runTurn
+        ProfilePhase_RecordWrite,       ///< Record への書き込み
+        ProfilePhase_OutputJson,        ///< JSON の出力
+        ProfilePhase_TERM
+    };
+
+    //------------------------------------------------------------------------------
+    /// 処理の区分とステージの種類ごとに、所要時間のヒストグラムを集計します。
+    ///
+    /// 計測は HPC_PROFILE を定義してビルドしたとき (make PROFILE=1) だけ行われます。
+    /// 定義しなければ HPC_PROFILE_SCOPE などのマクロは何も生成しません。
+    class Profiler
+    {
+    public:
+        static bool IsEnabled();                                ///< 計測が有効なビルドかどうかを返します。
+        static void SetStage(int aStageIndex);                  ///< 以降の計測を集計するステージを設定します。
+        static void Add(ProfilePhase aPhase, int64_t aNanoSec); ///< 所要時間を 1 つ記録します。
+        static int64_t NowNanoSec();                            ///< 計測に使う現在時刻を返します。
+        static void Print();                                    ///< 集計結果を表示します。
+        static void Reset();                                    ///< 集計を消去します。
+        static int64_t TotalNanoSec(ProfilePhase aPhase);       ///< 処理の区分の所要時間の合計を返します。
+        static const char* PhaseName(ProfilePhase aPhase);      ///< 処理の区分の名前を返します。
+
+    private:
+        Profiler();
+    };
+
+    //------------------------------------------------------------------------------
+    /// 生成から破棄までの時間を Profiler に記録します。
+    class ProfileScope
+    {
+    public:
+        explicit ProfileScope(ProfilePhase aPhase)
+            : mPhase(aPhase)
+            , mBegin(Profiler::NowNanoSec())
+        {
+        }
+
+        ~ProfileScope()
+        {
+            Profiler::Add(mPhase, Profiler::NowNanoSec() - mBegin);
+        }
+
+    private:
+        ProfileScope(const ProfileScope&);
+        ProfileScope& operator=(const ProfileScope&);
+
+        const ProfilePhase mPhase;  ///< 処理の区分
+        const int64_t mBegin;       ///< 開始時刻[ナノ秒]
+    };
+}
+
+#define HPC_PROFILE_CONCAT_IMPL(a, b) a##b
+#define HPC_PROFILE_CONCAT(a, b) HPC_PROFILE_CONCAT_IMPL(a, b)
+
+#ifdef HPC_PROFILE
+/// このスコープの終わりまでの時間を aPhase として記録します。
+#define HPC_PROFILE_SCOPE(aPhase) \
+    ::hpc::ProfileScope HPC_PROFILE_CONCAT(hpcProfileScope, __LINE__)(aPhase)
+/// 以降の記録をステージ aStageIndex の種類として集計します。
+#define HPC_PROFILE_SET_STAGE(aStageIndex) \
+    ::hpc::Profiler::SetStage(aStageIndex)
+#else
+#define HPC_PROFILE_SCOPE(aPhase) do {} while (false)
+#define HPC_PROFILE_SET_STAGE(aStageIndex) do {} while (false)
+#endif
+//------------------------------------------------------------------------------
+// EOF
@@ -10,6 +10,8 @@
 //------------------------------------------------------------------------------
 #include "HPCRandom.hpp"
 
+#include <cstdlib>
+
 #include "HPCCommon.hpp"
 
 namespace {
@@ -110,6 +112,25 @@ namespace hpc {
     }
 
     //------------------------------------------------------------------------------
+    /// "x,y,z,w" 形式のシードを読みます。10 進数と 0x で始まる 16 進数を受け付けます。
+    ///
+    /// @param[in]  aText  読む文字列。
+    /// @param[out] aSeeds 読んだシード。 SeedCount 個。
+    ///
+    /// @return 読めたら @c true 。
+    bool Random::ParseSeeds(const char* aText, uint* aSeeds)
+    {
+        const char* text = aText;
+        for (int i = 0; i < SeedCount; ++i) {
+            char* end = 0;
+            aSeeds[i] = static_cast<uint>(std::strtoul(text, &end, 0));
+            if (end == text || *end != (i + 1 < SeedCount ? ',' : '\0')) {
+                return false;
+            }
+            text = end + 1;
+        }
+        return true;
+    }
 }
 //------------------------------------------------------------------------------
 // EOF
@@ -28,6 +28,9 @@ namespace hpc {
         int randMinTerm(int aMin, int aTerm);   ///< [aMin, aTerm) の範囲で乱数を取得します。
         int randMinMax(int aMin, int aMax);     ///< [aMin, aMax] の範囲で乱数を取得します。
 
+        static const int SeedCount = 4;         ///< シードの数
+        static bool ParseSeeds(const char* aText, uint* aSeeds); ///< "x,y,z,w" 形式のシードを読みます。
+
     private:
         uint mSeedX;            ///< 乱数のシード
         uint mSeedY;            ///< 乱数のシード
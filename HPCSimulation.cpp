@@ -15,9 +15,16 @@
 #include <cstdlib>
 #include "HPCCommon.hpp"
 #include "HPCMath.hpp"
+#include "HPCProfiler.hpp"
 #include "HPCTimer.hpp"
+#include "HPCTrace.hpp"
 
 namespace {
+    /// 制限時間の既定の計測方法。
+    /// 制限時間があると Deadline の監視スレッドが動くので、その CPU 時間を数えないよう
+    /// 解答とシミュレーションを実行するスレッドの CPU 時間で測ります。
+    const hpc::TimerMode DefaultTimerMode = hpc::Parameter::GameTimeLimitSec != 0 ? hpc::TimerMode_ThreadCpu : hpc::TimerMode_ProcessCpu;
+
     /// 入力を受けるコマンド
     enum Command {
         Command_Debug,          ///< デバッガ起動
@@ -155,8 +162,80 @@ namespace hpc {
     Simulation::Simulation() 
         : mRandom()
         , mGame(mRandom)
-        , mTimer(Parameter::GameTimeLimitSec)
+        , mTimer(Parameter::GameTimeLimitSec, DefaultTimerMode)
+        , mDeadline(mTimer)
+    {
+    }
+
+    //------------------------------------------------------------------------------
+    /// @brief 指定の乱数でステージを生成する Simulation クラスのインスタンスを生成します。
+    ///
+    /// @param[in] aRandom ステージの生成に使う乱数。シードを変えて複数の問題を試すときに使います。
+    Simulation::Simulation(const Random& aRandom)
+        : mRandom(aRandom)
+        , mGame(mRandom)
+        , mTimer(Parameter::GameTimeLimitSec, DefaultTimerMode)
+        , mDeadline(mTimer)
+    {
+    }
+
+    //------------------------------------------------------------------------------
+    /// @brief 制限時間の計測方法を設定します。run より前に呼んでください。
+    ///
+    /// @param[in] aMode 計測する時間の種類。
+    void Simulation::setTimerMode(TimerMode aMode)
+    {
+        mTimer.setMode(aMode);
+    }
+
+    //------------------------------------------------------------------------------
+    /// @brief ステージの生成に使う乱数を設定します。run より前に呼んでください。
+    ///
+    /// @param[in] aRandom ステージの生成に使う乱数。
+    void Simulation::setRandom(const Random& aRandom)
+    {
+        mRandom = aRandom;
+    }
+
+    //------------------------------------------------------------------------------
+    /// @brief ステージごとの指標の出力先を開きます。run より前に呼んでください。
+    ///
+    /// @param[in] aPath 出力先のファイルパス。拡張子が .csv なら CSV 、それ以外なら NDJSON 。
+    ///
+    /// @return 開けたら @c true 。
+    bool Simulation::openMetrics(const char* aPath)
+    {
+        return mGame.metrics().open(aPath);
+    }
+
+    //------------------------------------------------------------------------------
+    /// @brief 実行された計画の分析を有効にします。run より前に呼んでください。
+    void Simulation::enablePlanAnalyzer()
+    {
+        mGame.planAnalyzer().enable();
+    }
+
+    //------------------------------------------------------------------------------
+    /// @brief 燃料の下界の計算を有効にします。run より前に呼んでください。
+    void Simulation::enableLowerBound()
+    {
+        mGame.lowerBound().enable();
+    }
+
+    //------------------------------------------------------------------------------
+    /// @brief 解答の待ち時間の集計を有効にします。run より前に呼んでください。
+    void Simulation::enableLatencyReport()
     {
+        mGame.latencyReport().enable();
+    }
+
+    //------------------------------------------------------------------------------
+    /// @brief 解答の待ち時間の目標を設定し、集計を有効にします。run より前に呼んでください。
+    ///
+    /// @param[in] aMilliSec ステージごとの待ち時間の LatencyReport::SloPercentile 分位点の上限[ミリ秒]。
+    void Simulation::setLatencySlo(double aMilliSec)
+    {
+        mGame.latencyReport().setSlo(aMilliSec);
     }
 
     //------------------------------------------------------------------------------
@@ -164,14 +243,24 @@ namespace hpc {
     void Simulation::run()
     {
         // 制限時間と制限ターン数
+        // ステージの開始時は Timer で正確に判定し、ターンごとの判定は監視スレッドのフラグを読むだけにする。
+        mGame.setTimerMode(mTimer.mode());
         mTimer.start();
+        mDeadline.start();
         while (mGame.isValidStage()) {
-            mGame.startStage(mTimer.isInTime());
-            while (mGame.state() == StageState_Playing && mTimer.isInTime()) {
-                mGame.runTurn();
+            HPC_TRACE_SCOPE("stage", "stage", mGame.currentStageIndex());
+            const double restSec = mTimer.limitSec() == 0 ? 0.0 : mTimer.limitSec() - mTimer.pastSec();
+            mGame.startStage(mTimer.isInTime(), restSec);
+            {
+                HPC_TRACE_SCOPE("simulate", "stage", mGame.currentStageIndex());
+                while (mGame.state() == StageState_Playing && mDeadline.isInTime()) {
+                    mGame.runTurn();
+                }
             }
             mGame.onStageDone();
         }
+        mDeadline.stop();
+        mGame.metrics().close();
     }
 
     //------------------------------------------------------------------------------
@@ -196,6 +285,34 @@ namespace hpc {
         HPC_PRINT("%8s:%8.4f\n", "Time", pastTimeSecForPrint());
     }
 
+    //------------------------------------------------------------------------------
+    /// 計画の分析結果を、ステージの種類ごとに表示します。有効にしていなければ何もしません。
+    void Simulation::outputPlanAnalysis()const
+    {
+        mGame.planAnalyzer().print();
+    }
+
+    //------------------------------------------------------------------------------
+    /// 燃料の下界と最適性ギャップを、ステージごととステージの種類ごとに表示します。有効にしていなければ何もしません。
+    void Simulation::outputLowerBound()const
+    {
+        mGame.lowerBound().print();
+    }
+
+    //------------------------------------------------------------------------------
+    /// 解答の待ち時間の分位点を、全体と荷物数の区分ごとに表示します。有効にしていなければ何もしません。
+    void Simulation::outputLatencyReport()const
+    {
+        mGame.latencyReport().print();
+    }
+
+    //------------------------------------------------------------------------------
+    /// @return 待ち時間の目標を設定していて、それを超えていれば @c true 。
+    bool Simulation::isLatencySloBreached()const
+    {
+        return mGame.latencyReport().isSloBreached();
+    }
+
     //------------------------------------------------------------------------------
     /// @brief ゲームをデバッグ実行します。
     void Simulation::debug()
@@ -210,6 +327,7 @@ namespace hpc {
         case Command_OutputJson:
             // 時間切れの場合は、JSONが不完全になるので出力を行わない。
             if (mTimer.isInTime()) {
+                HPC_PROFILE_SCOPE(ProfilePhase_OutputJson);
                 mGame.record().dumpJson(true);
             }
             break;
@@ -229,6 +347,8 @@ namespace hpc {
     {
         // 時間切れの場合は、JSONが不完全になるので出力を行わない。
         if (mTimer.isInTime()) {
+            HPC_PROFILE_SCOPE(ProfilePhase_OutputJson);
+            HPC_TRACE_SCOPE("outputJson", "output", 0);
             mGame.record().dumpJson(isCompressed);
         }
     }
@@ -13,6 +13,7 @@
 #include "HPCGame.hpp"
 #include "HPCRandom.hpp"
 #include "HPCTimer.hpp"
+#include "HPCDeadline.hpp"
 
 namespace hpc {
 
@@ -22,18 +23,31 @@ namespace hpc {
     {
     public:
         Simulation();
+        explicit Simulation(const Random& aRandom);
 
+        void setTimerMode(TimerMode aMode);            ///< 制限時間の計測方法を設定する
+        void setRandom(const Random& aRandom);         ///< ステージの生成に使う乱数を設定する
+        bool openMetrics(const char* aPath);           ///< ステージごとの指標の出力先を開く
+        void enablePlanAnalyzer();                     ///< 実行された計画の分析を有効にする
+        void enableLowerBound();                       ///< 燃料の下界の計算を有効にする
+        void enableLatencyReport();                    ///< 解答の待ち時間の集計を有効にする
+        void setLatencySlo(double aMilliSec);          ///< 解答の待ち時間の目標を設定する
         void run();                                    ///< 開始する
         int score() const;                             ///< スコアを取得
         double pastTimeSecForPrint() const;            ///< 表示用時間取得
         void debug();                                  ///< デバッグする
         void outputResult()const;                     ///< 結果を表示する。
         void outputJson(bool isCompressed)const;      ///< JSON の出力を行う。
+        void outputPlanAnalysis()const;               ///< 計画の分析結果を表示する。
+        void outputLowerBound()const;                 ///< 燃料の下界と最適性ギャップを表示する。
+        void outputLatencyReport()const;              ///< 解答の待ち時間の分位点を表示する。
+        bool isLatencySloBreached()const;             ///< 解答の待ち時間が目標を超えたかを取得
         
     private:
         Random mRandom;     ///< 乱数生成クラス
         Game mGame;         ///< シミュレーションするゲーム
         Timer mTimer;       ///< ゲームタイマー
+        Deadline mDeadline; ///< ターンごとの時間切れ判定
 
         void runDebugger();
     };
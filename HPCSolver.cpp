@@ -0,0 +1,191 @@
+//------------------------------------------------------------------------------
+/// @file
+/// @brief    HPCSolver.hpp の実装
+/// @author   ハル研究所プログラミングコンテスト実行委員会
+///
+/// @copyright  Copyright (c) 2015 HAL Laboratory, Inc.
+/// @attention  このファイルの利用は、同梱のREADMEにある
+///             利用条件に従ってください
+
+//------------------------------------------------------------------------------
+
+#include "HPCSolver.hpp"
+
+#include <cstring>
+#include "HPCAnswer.hpp"
+#include "HPCCommon.hpp"
+
+#if !defined(_WIN32)
+#include <dlfcn.h>
+#endif
+
+namespace {
+    using namespace hpc;
+
+    /// 一緒にリンクした Answer.cpp の解答
+    const SolverEntry AnswerEntry = {
+        "answer",
+        "Answer.cpp linked into this executable",
+        &Answer::Init,
+        &Answer::InitPeriod,
+        &Answer::GetNextAction,
+        &Answer::FinalizePeriod,
+        &Answer::Finalize,
+    };
+
+    /// 登録されている解答。先頭は常に AnswerEntry 。
+    const SolverEntry* sEntries[Solver::SolverCountMax] = { &AnswerEntry };
+    int sEntryCount = 1;
+
+    /// 選ばれている解答
+    const SolverEntry* sCurrent = &AnswerEntry;
+
+    /// 共有ライブラリの HpcSolverEntry の型
+    typedef const SolverEntry* (*EntryFunction)();
+
+    //------------------------------------------------------------------------------
+    /// @return 名前が共有ライブラリのパスらしければ @c true 。
+    bool IsLibraryPath(const char* aName)
+    {
+        const size_t length = std::strlen(aName);
+        return std::strchr(aName, '/') != 0 || (length > 3 && !std::strcmp(aName + length - 3, ".so"));
+    }
+}
+
+namespace hpc {
+
+    //------------------------------------------------------------------------------
+    /// 解答を登録します。
+    ///
+    /// @param[in] aEntry 解答の入口の表。登録した後も破棄しないでください。
+    ///
+    /// @return 登録できたら @c true 。同じ名前の解答があるか、数が上限に達していたら @c false 。
+    bool Solver::Register(const SolverEntry& aEntry)
+    {
+        HPC_ASSERT(aEntry.name != 0);
+        HPC_ASSERT(aEntry.init != 0 && aEntry.initPeriod != 0 && aEntry.getNextAction != 0);
+        HPC_ASSERT(aEntry.finalizePeriod != 0 && aEntry.finalize != 0);
+        if (Find(aEntry.name) != 0 || sEntryCount >= SolverCountMax) {
+            return false;
+        }
+        sEntries[sEntryCount++] = &aEntry;
+        return true;
+    }
+
+    //------------------------------------------------------------------------------
+    /// 共有ライブラリから解答を読み込んで登録します。
+    ///
+    /// 共有ライブラリは HPC_SOLVER_ENTRY_SYMBOL の関数を公開している必要があります。
+    /// 読み込んだ共有ライブラリは閉じません。
+    ///
+    /// @param[in] aPath 共有ライブラリのパス。
+    ///
+    /// @return 登録した解答。読み込めなかったら 0 。
+    const SolverEntry* Solver::Load(const char* aPath)
+    {
+#if !defined(_WIN32)
+        void* handle = dlopen(aPath, RTLD_NOW | RTLD_LOCAL);
+        if (handle == 0) {
+            HPC_PRINT("Cannot load %s: %s\n", aPath, dlerror());
+            return 0;
+        }
+        EntryFunction function = reinterpret_cast<EntryFunction>(dlsym(handle, HPC_SOLVER_ENTRY_SYMBOL));
+        const SolverEntry* entry = function != 0 ? function() : 0;
+        if (entry == 0) {
+            HPC_PRINT("Cannot load %s: %s is not found.\n", aPath, HPC_SOLVER_ENTRY_SYMBOL);
+            dlclose(handle);
+            return 0;
+        }
+        const SolverEntry* registered = Find(entry->name);
+        if (registered == entry) {
+            return entry;
+        }
+        if (registered != 0 || !Register(*entry)) {
+            HPC_PRINT("Cannot load %s: solver %s cannot be registered.\n", aPath, entry->name);
+            dlclose(handle);
+            return 0;
+        }
+        return entry;
+#else
+        HPC_PRINT("Cannot load %s: shared library solvers are not supported on this platform.\n", aPath);
+        return 0;
+#endif
+    }
+
+    //------------------------------------------------------------------------------
+    /// @return 登録されている解答の数。
+    int Solver::Count()
+    {
+        return sEntryCount;
+    }
+
+    //------------------------------------------------------------------------------
+    /// @param[in] aIndex 登録順の番号。
+    ///
+    /// @return 登録されている解答。
+    const SolverEntry& Solver::At(int aIndex)
+    {
+        HPC_RANGE_ASSERT_MIN_UB_I(aIndex, 0, sEntryCount);
+        return *sEntries[aIndex];
+    }
+
+    //------------------------------------------------------------------------------
+    /// @param[in] aName 解答の名前。
+    ///
+    /// @return 見つかった解答。なければ 0 。
+    const SolverEntry* Solver::Find(const char* aName)
+    {
+        for (int i = 0; i < sEntryCount; ++i) {
+            if (!std::strcmp(sEntries[i]->name, aName)) {
+                return sEntries[i];
+            }
+        }
+        return 0;
+    }
+
+    //------------------------------------------------------------------------------
+    /// 名前か共有ライブラリのパスで解答を選びます。
+    ///
+    /// パスに / を含むか .so で終わる場合は、共有ライブラリとして読み込んでから選びます。
+    ///
+    /// @return 選べたら @c true 。
+    bool Solver::Select(const char* aNameOrPath)
+    {
+        const SolverEntry* entry = IsLibraryPath(aNameOrPath) ? Load(aNameOrPath) : Find(aNameOrPath);
+        if (entry == 0) {
+            return false;
+        }
+        sCurrent = entry;
+        return true;
+    }
+
+    //------------------------------------------------------------------------------
+    /// 登録されていない解答も選べます。(計測用に一時的に差し替える場合など)
+    ///
+    /// @param[in] aEntry 解答の入口の表。選んでいる間は破棄しないでください。
+    void Solver::Select(const SolverEntry& aEntry)
+    {
+        sCurrent = &aEntry;
+    }
+
+    //------------------------------------------------------------------------------
+    /// @return 選ばれている解答。
+    const SolverEntry& Solver::Current()
+    {
+        return *sCurrent;
+    }
+
+    //------------------------------------------------------------------------------
+    /// 登録されている解答の一覧を表示します。選ばれている解答には * を付けます。
+    void Solver::PrintList()
+    {
+        HPC_PRINT("Solvers:\n");
+        for (int i = 0; i < sEntryCount; ++i) {
+            HPC_PRINT("  %c %-16s %s\n", sEntries[i] == sCurrent ? '*' : ' ', sEntries[i]->name,
+                sEntries[i]->description != 0 ? sEntries[i]->description : "");
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+// EOF
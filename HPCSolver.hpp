@@ -0,0 +1,65 @@
+//------------------------------------------------------------------------------
+/// @file
+/// @brief    Solver クラス
+/// @author   ハル研究所プログラミングコンテスト実行委員会
+///
+/// @copyright  Copyright (c) 2015 HAL Laboratory, Inc.
+/// @attention  このファイルの利用は、同梱のREADMEにある
+///             利用条件に従ってください
+
+//------------------------------------------------------------------------------
+#pragma once
+
+#include "HPCAction.hpp"
+#include "HPCItemGroup.hpp"
+#include "HPCStageState.hpp"
+
+/// 共有ライブラリの解答が公開する関数の名前です。
+/// 関数は extern "C" const hpc::SolverEntry* HpcSolverEntry() の形で、解答の入口の表を返します。
+#define HPC_SOLVER_ENTRY_SYMBOL "HpcSolverEntry"
+
+namespace hpc {
+
+    class Stage;
+
+    //------------------------------------------------------------------------------
+    /// 解答の入口(Answer の 5 つの関数)をまとめた表です。
+    struct SolverEntry
+    {
+        const char* name;                                                           ///< 選ぶときの名前
+        const char* description;                                                    ///< 一覧に表示する説明
+        void (*init)(const Stage& aStage);                                          ///< Answer::Init にあたる関数
+        void (*initPeriod)(const Stage& aStage, ItemGroup& aItemGroup);             ///< Answer::InitPeriod にあたる関数
+        Action (*getNextAction)(const Stage& aStage);                               ///< Answer::GetNextAction にあたる関数
+        void (*finalizePeriod)(const Stage& aStage, StageState aStageState, int aCost); ///< Answer::FinalizePeriod にあたる関数
+        void (*finalize)(const Stage& aStage, StageState aStageState, int aScore);  ///< Answer::Finalize にあたる関数
+    };
+
+    //------------------------------------------------------------------------------
+    /// 解答の登録と選択を行います。
+    ///
+    /// Stage は Answer を直接呼ばず、選ばれている解答(Current)の入口を呼びます。
+    /// 既定では、一緒にリンクした Answer.cpp の解答("answer")が選ばれています。
+    /// ほかの解答は、ハーネスの中から Register で登録するか、
+    /// 共有ライブラリ(make plugins で Answer_bak/ から作られます)から Load で読み込みます。
+    class Solver
+    {
+    public:
+        static const int SolverCountMax = 32;                   ///< 登録できる解答の最大数
+
+        static bool Register(const SolverEntry& aEntry);        ///< 解答を登録します。
+        static const SolverEntry* Load(const char* aPath);      ///< 共有ライブラリから解答を読み込んで登録します。
+        static int Count();                                     ///< 登録されている解答の数を返します。
+        static const SolverEntry& At(int aIndex);               ///< 登録されている解答を返します。
+        static const SolverEntry* Find(const char* aName);      ///< 名前で解答を探します。
+        static bool Select(const char* aNameOrPath);            ///< 解答を選びます。
+        static void Select(const SolverEntry& aEntry);          ///< 解答を選びます。
+        static const SolverEntry& Current();                    ///< 選ばれている解答を返します。
+        static void PrintList();                                ///< 登録されている解答の一覧を表示します。
+
+    private:
+        Solver();
+    };
+}
+//------------------------------------------------------------------------------
+// EOF
@@ -11,9 +11,12 @@
 
 #include "HPCStage.hpp"
 
-#include "HPCAnswer.hpp"
 #include "HPCCommon.hpp"
 #include "HPCParameter.hpp"
+#include "HPCProfiler.hpp"
+#include "HPCSolver.hpp"
+#include "HPCTimer.hpp"
+#include "HPCTrace.hpp"
 
 namespace hpc {
 
@@ -29,6 +32,11 @@ namespace hpc {
         , mTruck(*this)
         , mTurnResult()
         , mTurnIndex(0)
+        , mSolveTimeLimitSec(0.0)
+        , mTimerMode(TimerMode_ProcessCpu)
+        , mSolveSec(0.0)
+        , mInitPeriodSec(0.0)
+        , mPeriodBeginNanoSec(0)
     {
     }
 
@@ -63,8 +71,14 @@ namespace hpc {
         truck().reset();
 
         // Answerを初期化
+        mSolveSec = 0.0;
+        mInitPeriodSec = 0.0;
         if (aIsInTime) {
-            Answer::Init(*this);
+            HPC_PROFILE_SCOPE(ProfilePhase_Init);
+            Timer solveTimer(0, TimerMode_Wall);
+            solveTimer.start();
+            Solver::Current().init(*this);
+            mSolveSec = solveTimer.pastSec();
         }
 
         updateTurnResult(false, Action_TERM);
@@ -118,7 +132,17 @@ namespace hpc {
             // トラックが空であり、かつ営業所にいるので、配達時間帯を開始する。
             mPeriod++;
             ItemGroup itemGroup;
-            Answer::InitPeriod(*this, itemGroup);
+            if (Trace::IsEnabled()) {
+                mPeriodBeginNanoSec = Trace::NowNanoSec();
+            }
+            {
+                HPC_PROFILE_SCOPE(ProfilePhase_InitPeriod);
+                HPC_TRACE_SCOPE("InitPeriod", "answer", mPeriod);
+                Timer initPeriodTimer(0, TimerMode_Wall);
+                initPeriodTimer.start();
+                Solver::Current().initPeriod(*this, itemGroup);
+                mInitPeriodSec += initPeriodTimer.pastSec();
+            }
             mPeriodCost = 0;
 
             // トラックに積み込まれた荷物が妥当か検査。
@@ -176,14 +200,17 @@ namespace hpc {
             else {
                 // トラックに積み込まれた荷物が妥当ではなかった場合は、直ちに終了。
                 // この場合は、結果の保存も行われない。
-                Answer::FinalizePeriod(*this, mTurnResult.state, 0);
-                Answer::Finalize(*this, mTurnResult.state, 0);
+                Solver::Current().finalizePeriod(*this, mTurnResult.state, 0);
+                Solver::Current().finalize(*this, mTurnResult.state, 0);
                 return;
             }
         }
         else {
             // 配達中。
-            action = Answer::GetNextAction(*this);
+            {
+                HPC_PROFILE_SCOPE(ProfilePhase_GetNextAction);
+                action = Solver::Current().getNextAction(*this);
+            }
             int cost = runAction(action);
             mPeriodCost += cost;
         }
@@ -193,8 +220,11 @@ namespace hpc {
 
         if (truck().itemGroup().hasAnyItems() == false && truck().pos() == field().officePos()) {
             // トラックが空であり、かつ営業所にいるので、この配達時間帯を終了する。
-            Answer::FinalizePeriod(*this, mTurnResult.state, mPeriodCost);
+            Solver::Current().finalizePeriod(*this, mTurnResult.state, mPeriodCost);
             mTotalCost += mPeriodCost;
+            if (Trace::IsEnabled()) {
+                Trace::Add("period", "period", mPeriodBeginNanoSec, Trace::NowNanoSec(), mPeriod);
+            }
             for (int i = 0; i < items().count(); ++i) {
                 if (mTransportStates[i] == TransportState_Transporting) {
                     mTransportStates[i] = TransportState_Transported;
@@ -215,7 +245,7 @@ namespace hpc {
 
         if (mTurnResult.state != StageState_Playing) {
             // 終了
-            Answer::Finalize(*this, mTurnResult.state, score());
+            Solver::Current().finalize(*this, mTurnResult.state, score());
         }
     }
 
@@ -279,6 +309,85 @@ namespace hpc {
         return mTransportStates[aIndex];
     }
 
+    //------------------------------------------------------------------------------
+    /// 解答の初期化(Answer::Init)に使える時間を返します。
+    ///
+    /// ゲーム全体に制限時間があるとき、StageScheduler が残り時間から割り振ります。
+    ///
+    /// @return 使える時間[秒]。0 なら制限なし。
+    double Stage::solveTimeLimitSec()const
+    {
+        return mSolveTimeLimitSec;
+    }
+
+    //------------------------------------------------------------------------------
+    /// 制限時間の計測方法を返します。
+    ///
+    /// solveTimeLimitSec はゲームの制限時間から割り振ったものなので、
+    /// 解答もこの方法で測ると、ゲームの判定と食い違いません。
+    ///
+    /// @return ゲームの制限時間と同じ計測方法。
+    TimerMode Stage::timerMode()const
+    {
+        return mTimerMode;
+    }
+
+    //------------------------------------------------------------------------------
+    /// 解答の初期化(Answer::Init)にかかった時間を返します。
+    ///
+    /// @return 実時間[秒]。制限時間切れで呼ばれなかった場合は 0 。
+    double Stage::solveSec()const
+    {
+        return mSolveSec;
+    }
+
+    //------------------------------------------------------------------------------
+    /// 解答の時間帯ごとの初期化(Answer::InitPeriod)にかかった時間の合計を返します。
+    ///
+    /// @return このステージで Answer::InitPeriod にかかった実時間の合計[秒]。
+    double Stage::initPeriodSec()const
+    {
+        return mInitPeriodSec;
+    }
+
+    //------------------------------------------------------------------------------
+    /// 実行したターン数を返します。
+    ///
+    /// @return ステージ開始から実行したターン数。積み込みのターンも含みます。
+    int Stage::turn()const
+    {
+        return mTurnIndex;
+    }
+
+    //------------------------------------------------------------------------------
+    /// 終えた配達時間帯で消費した燃料を返します。
+    ///
+    /// @note lastTurnResult().totalCost は時間帯を終える前に記録されるため、最後の時間帯を含みません。
+    ///
+    /// @return 燃料の合計。ステージを完了していれば、得点の計算に使う値と同じです。
+    int Stage::totalCost()const
+    {
+        return mTotalCost;
+    }
+
+    //------------------------------------------------------------------------------
+    /// 解答の初期化に使える時間を設定します。
+    ///
+    /// @param[in] aLimitSec 使える時間[秒]。0 なら制限なし。
+    void Stage::setSolveTimeLimitSec(double aLimitSec)
+    {
+        mSolveTimeLimitSec = aLimitSec;
+    }
+
+    //------------------------------------------------------------------------------
+    /// 制限時間の計測方法を設定します。
+    ///
+    /// @param[in] aMode ゲームの制限時間の計測方法。
+    void Stage::setTimerMode(TimerMode aMode)
+    {
+        mTimerMode = aMode;
+    }
+
     //------------------------------------------------------------------------------
     /// TurnResultの情報を更新します。
     void Stage::updateTurnResult(bool aInitPeriod, Action aAction)
@@ -10,12 +10,22 @@
 //------------------------------------------------------------------------------
 #pragma once
 
+#include <cstdint>
 #include "HPCField.hpp"
 #include "HPCItemCollection.hpp"
+#include "HPCTimer.hpp"
 #include "HPCTransportState.hpp"
 #include "HPCTruck.hpp"
 #include "HPCTurnResult.hpp"
 
+/// Stage::solveTimeLimitSec があることを示します。
+/// 解答はこれが定義されているときだけ、ステージごとの制限時間を参照してください。
+#define HPC_STAGE_SOLVE_TIME_LIMIT
+
+/// Stage::timerMode があることを示します。
+/// 解答はこれが定義されているときだけ、制限時間の計測方法を参照してください。
+#define HPC_STAGE_TIMER_MODE
+
 namespace hpc {
 
     //------------------------------------------------------------------------------
@@ -42,7 +52,15 @@ namespace hpc {
         Truck& truck();                     ///< トラック情報を返します。
         int period() const;                 ///< 現在の配達時間帯を返します。
         TransportState getTransportState(int aIndex) const; ///< 指定荷物の配達状況を取得します。
+        double solveTimeLimitSec() const;   ///< 解答の初期化に使える時間を返します。
+        TimerMode timerMode() const;        ///< 制限時間の計測方法を返します。
+        double solveSec() const;            ///< 解答の初期化にかかった時間を返します。
+        double initPeriodSec() const;       ///< 解答の時間帯ごとの初期化にかかった時間の合計を返します。
+        int turn() const;                   ///< 実行したターン数を返します。
+        int totalCost() const;              ///< 終えた配達時間帯で消費した燃料を返します。
         //@}
+        void setSolveTimeLimitSec(double aLimitSec); ///< 解答の初期化に使える時間を設定します。
+        void setTimerMode(TimerMode aMode); ///< 制限時間の計測方法を設定します。
         int score() const;                  ///< スコアを返します。
 
     private:
@@ -57,6 +75,11 @@ namespace hpc {
         Truck mTruck;                   ///< トラック情報
         TurnResult mTurnResult;         ///< ターンの実行結果
         int mTurnIndex;                 ///< 現在のターン番号
+        double mSolveTimeLimitSec;      ///< 解答の初期化に使える時間[秒]。0 なら制限なし。
+        TimerMode mTimerMode;           ///< 制限時間の計測方法
+        double mSolveSec;               ///< 解答の初期化にかかった時間[秒]。(実時間)
+        double mInitPeriodSec;          ///< 解答の時間帯ごとの初期化にかかった時間の合計[秒]。(実時間)
+        int64_t mPeriodBeginNanoSec;    ///< この時間帯の開始時刻。(Trace の時計)
 
         void updateTurnResult(bool aInitPeriod, Action aAction); ///< TurnResultを更新します。
     };
@@ -0,0 +1,83 @@
+//------------------------------------------------------------------------------
+/// @file
+/// @brief HPCStageScheduler.hpp の実装
+/// @author ハル研究所プログラミングコンテスト実行委員会
+///
+/// @copyright  Copyright (c) 2015 HAL Laboratory, Inc.
+/// @attention  このファイルの利用は、同梱のREADMEにある
+///             利用条件に従ってください
+
+//------------------------------------------------------------------------------
+
+#include "HPCStageScheduler.hpp"
+
+#include "HPCCommon.hpp"
+#include "HPCLevelDesigner.hpp"
+#include "HPCStage.hpp"
+
+namespace {
+    using namespace hpc;
+
+    /// ステージの実行(ターンの処理)のために残しておく時間の割合。
+    const double PlayReserveRatio = 0.1;
+
+    /// フィールドの大きさが分からないステージに使う、平均的なマス数。
+    const int AverageCellCount = ((Parameter::FieldWidthMin + Parameter::FieldWidthMax) / 2) * ((Parameter::FieldHeightMin + Parameter::FieldHeightMax) / 2);
+}
+
+namespace hpc {
+
+    //------------------------------------------------------------------------------
+    /// クラスのインスタンスを生成します。
+    ///
+    /// まだ生成されていないステージのフィールドの大きさは分からないので、平均的な大きさで見積もります。
+    StageScheduler::StageScheduler()
+    {
+        mRestDifficulty[Parameter::GameStageCount] = 0.0;
+        for (int i = Parameter::GameStageCount - 1; i >= 0; --i) {
+            mRestDifficulty[i] = mRestDifficulty[i + 1] + Difficulty(i, AverageCellCount);
+        }
+    }
+
+    //------------------------------------------------------------------------------
+    /// ステージの解答の初期化に使える時間を返します。
+    ///
+    /// @param[in] aStageIndex ステージ番号。
+    /// @param[in] aStage      生成済みのステージ。フィールドの大きさを見積もりに使います。
+    /// @param[in] aRestSec    ゲーム全体の残り時間[秒]。0 以下なら制限なし。
+    ///
+    /// @return 使える時間[秒]。制限がないときは 0 を返します。
+    double StageScheduler::stageBudgetSec(int aStageIndex, const Stage& aStage, double aRestSec)const
+    {
+        HPC_RANGE_ASSERT_MIN_UB_I(aStageIndex, 0, Parameter::GameStageCount);
+        if (aRestSec <= 0.0) {
+            return 0.0;
+        }
+        const double difficulty = Difficulty(aStageIndex, aStage.field().width() * aStage.field().height());
+        const double restDifficulty = difficulty + mRestDifficulty[aStageIndex + 1];
+        return aRestSec * (1.0 - PlayReserveRatio) * difficulty / restDifficulty;
+    }
+
+    //------------------------------------------------------------------------------
+    /// ステージの予想難易度を返します。
+    ///
+    /// 荷物数と時間帯指定の割合は、ステージ番号から LevelDesigner の段階を引いて求めます。
+    /// 荷物数の2乗に比例し、時間帯指定のない荷物が多いほど(割り当ての選択肢が多いほど)、
+    /// フィールドが広いほど(経路の表が大きいほど)重くなるとみなします。
+    ///
+    /// @param[in] aStageIndex ステージ番号。
+    /// @param[in] aCellCount  フィールドのマス数。
+    ///
+    /// @return 予想難易度。単位はなく、比だけに意味があります。
+    double StageScheduler::Difficulty(int aStageIndex, int aCellCount)
+    {
+        const int periodSpecifiedIndex = LevelDesigner::PeriodSpecifiedIndex(aStageIndex);
+        const int itemCount = LevelDesigner::ItemCountIndex(aStageIndex) + 1;
+        const int periodSpecifiedCount = itemCount * periodSpecifiedIndex / (Parameter::PeriodSpecifiedMax - 1);
+        const double freeRatio = static_cast<double>(itemCount - periodSpecifiedCount) / itemCount;
+        return (1.0 + itemCount * itemCount) * (1.0 + freeRatio) * aCellCount / AverageCellCount;
+    }
+}
+
+//------------------------------------------------------------------------------
+// EOF
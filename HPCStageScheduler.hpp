@@ -0,0 +1,37 @@
+//------------------------------------------------------------------------------
+/// @file
+/// @brief StageScheduler クラス
+/// @author ハル研究所プログラミングコンテスト実行委員会
+///
+/// @copyright  Copyright (c) 2015 HAL Laboratory, Inc.
+/// @attention  このファイルの利用は、同梱のREADMEにある
+///             利用条件に従ってください
+
+//------------------------------------------------------------------------------
+#pragma once
+
+#include "HPCParameter.hpp"
+
+namespace hpc {
+    class Stage;
+
+    //------------------------------------------------------------------------------
+    /// 全ステージで共有する制限時間を、各ステージの解答の初期化に割り振ります。
+    ///
+    /// 残り時間を、このステージと残りのステージの予想難易度の比で分けます。
+    /// 使い切らなかった時間は残り時間に含まれるので、自然に後のステージへ持ち越されます。
+    class StageScheduler
+    {
+    public:
+        StageScheduler();
+
+        double stageBudgetSec(int aStageIndex, const Stage& aStage, double aRestSec)const; ///< ステージの解答に使える時間を返します。
+
+        static double Difficulty(int aStageIndex, int aCellCount); ///< ステージの予想難易度を返します。
+
+    private:
+        double mRestDifficulty[Parameter::GameStageCount + 1]; ///< [i] ステージ i 以降の予想難易度の合計
+    };
+}
+//------------------------------------------------------------------------------
+// EOF
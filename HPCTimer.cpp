@@ -11,27 +11,48 @@
 
 #include "HPCTimer.hpp"
 
+#include <chrono>
+#include "HPCCommon.hpp"
+
 namespace {
 
+    /// 1秒あたりのナノ秒数。
+    const double NanoSecPerSec = 1e9;
+
     //------------------------------------------------------------------------------
-    /// 現在の時間を取得します。
+    /// 単調増加する時計の現在の時刻を取得します。
     ///
-    /// @return 現在の時刻を表す std::clock_t 型オブジェクト。
-    std::clock_t GetCurrentTime()
+    /// @return 現在の時刻[ナノ秒]。
+    int64_t GetWallNanoSec()
     {
-        return ::std::clock();
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
     }
 
+#if defined(_WIN32)
+    //------------------------------------------------------------------------------
+    /// std::clock で CPU 時間を取得します。
+    ///
+    /// clock_gettime のない環境では、スレッドごとの CPU 時間もプロセスの CPU 時間で代用します。
+    ///
+    /// @return 現在の CPU 時間[ナノ秒]。
+    int64_t GetClockNanoSec()
+    {
+        return static_cast<int64_t>(static_cast<double>(::std::clock()) * NanoSecPerSec / CLOCKS_PER_SEC);
+    }
+#else
     //------------------------------------------------------------------------------
-    /// std::clock_t で表される時間を秒に変換します。
+    /// 指定した時計の現在の時刻を取得します。
     ///
-    /// @param[in] aTime std::clock_t 型で表される時間
+    /// @param[in] aClock 時計の種類。
     ///
-    /// @return aTime を秒に変換した値。
-    double ToSec(std::clock_t aTime)
+    /// @return 現在の時刻[ナノ秒]。
+    int64_t GetClockNanoSec(clockid_t aClock)
     {
-        return static_cast<double>(aTime) / CLOCKS_PER_SEC;
+        timespec time;
+        clock_gettime(aClock, &time);
+        return static_cast<int64_t>(time.tv_sec) * 1000000000 + time.tv_nsec;
     }
+#endif
 }
 
 namespace hpc {
@@ -42,18 +63,53 @@ namespace hpc {
     /// @note 生成しただけでは計測を行いません。
     ///       計測を行うには start 関数を呼び出します。
     ///
-    /// @param[in] aLimitSec 制限時間を秒で指定。
-    Timer::Timer(int aLimitSec)
+    /// @param[in] aLimitSec 制限時間を秒で指定。1秒未満の端数も指定できます。
+    /// @param[in] aMode     計測する時間の種類。
+    Timer::Timer(double aLimitSec, TimerMode aMode)
         : mLimitSec(aLimitSec)
-        , mTimeBegin(std::clock_t())
+        , mMode(aMode)
+        , mTimeBegin(0)
+#if !defined(_WIN32)
+        , mThreadClock(CLOCK_THREAD_CPUTIME_ID)
+#endif
     {
+        HPC_RANGE_ASSERT_MIN_UB_I(aMode, 0, TimerMode_TERM);
+    }
+
+    //------------------------------------------------------------------------------
+    /// 計測する時間の種類を設定します。
+    ///
+    /// @note start を呼ぶ前に設定してください。
+    ///
+    /// @param[in] aMode 計測する時間の種類。
+    void Timer::setMode(TimerMode aMode)
+    {
+        HPC_RANGE_ASSERT_MIN_UB_I(aMode, 0, TimerMode_TERM);
+        mMode = aMode;
+    }
+
+    //------------------------------------------------------------------------------
+    /// 計測する時間の種類を取得します。
+    ///
+    /// @return 計測する時間の種類。
+    TimerMode Timer::mode()const
+    {
+        return mMode;
     }
 
     //------------------------------------------------------------------------------
     /// タイマーの計測を開始します。
+    ///
+    /// TimerMode_ThreadCpu では、この関数を呼んだスレッドの CPU 時間を計測します。
+    /// 他のスレッドから pastSec や isInTime を呼んでも、計測するスレッドは変わりません。
     void Timer::start()
     {
-        mTimeBegin = GetCurrentTime();
+#if !defined(_WIN32)
+        if (mMode == TimerMode_ThreadCpu && pthread_getcpuclockid(pthread_self(), &mThreadClock) != 0) {
+            mThreadClock = CLOCK_THREAD_CPUTIME_ID;
+        }
+#endif
+        mTimeBegin = currentNanoSec();
     }
 
     //------------------------------------------------------------------------------
@@ -62,7 +118,16 @@ namespace hpc {
     /// @return start を呼び出してからの経過時間を秒に変換したもの。
     double Timer::pastSec()const
     {
-        return ToSec(GetCurrentTime() - mTimeBegin);
+        return static_cast<double>(currentNanoSec() - mTimeBegin) / NanoSecPerSec;
+    }
+
+    //------------------------------------------------------------------------------
+    /// 制限時間を取得します。
+    ///
+    /// @return 制限時間[秒]。0 なら制限なし。
+    double Timer::limitSec()const
+    {
+        return mLimitSec;
     }
 
     //------------------------------------------------------------------------------
@@ -87,6 +152,49 @@ namespace hpc {
     {
         return mLimitSec == 0 || pastSec() < mLimitSec;
     }
+
+    //------------------------------------------------------------------------------
+    /// 計測する時間の種類の名前を取得します。
+    ///
+    /// @param[in] aMode 計測する時間の種類。
+    ///
+    /// @return 名前の文字列。コマンドライン引数と同じものです。
+    const char* Timer::ModeName(TimerMode aMode)
+    {
+        switch (aMode) {
+        case TimerMode_Wall:        return "wall";
+        case TimerMode_ProcessCpu:  return "process";
+        case TimerMode_ThreadCpu:   return "thread";
+        default:
+            HPC_SHOULD_NOT_REACH_HERE();
+            return "";
+        }
+    }
+
+    //------------------------------------------------------------------------------
+    /// 計測する時間の種類に応じて、現在の時刻を取得します。
+    ///
+    /// @return 現在の時刻[ナノ秒]。
+    int64_t Timer::currentNanoSec()const
+    {
+        switch (mMode) {
+        case TimerMode_Wall:
+            return GetWallNanoSec();
+#if defined(_WIN32)
+        case TimerMode_ProcessCpu:
+        case TimerMode_ThreadCpu:
+            return GetClockNanoSec();
+#else
+        case TimerMode_ProcessCpu:
+            return GetClockNanoSec(CLOCK_PROCESS_CPUTIME_ID);
+        case TimerMode_ThreadCpu:
+            return GetClockNanoSec(mThreadClock);
+#endif
+        default:
+            HPC_SHOULD_NOT_REACH_HERE();
+            return 0;
+        }
+    }
 }
 //------------------------------------------------------------------------------
 // EOF
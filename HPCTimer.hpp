@@ -11,25 +11,51 @@
 #pragma once
 
 #include <ctime>
+#include <cstdint>
+
+#if !defined(_WIN32)
+#include <pthread.h>
+#endif
 
 namespace hpc {
 
+    //------------------------------------------------------------------------------
+    /// タイマーが計測する時間の種類を表します。
+    enum TimerMode {
+        TimerMode_Wall,         ///< 実時間(単調増加する時計)
+        TimerMode_ProcessCpu,   ///< プロセスの CPU 時間(全スレッドの合計)
+        TimerMode_ThreadCpu,    ///< start を呼んだスレッドの CPU 時間
+        TimerMode_TERM
+    };
+
     //------------------------------------------------------------------------------
     /// 実時間計測を行うタイマーを提供します。
+    ///
+    /// 時刻はナノ秒単位で保持します。
     class Timer
     {
     public:
-        Timer(int aLimitSec);               ///< 制限時間を定めてインスタンスを生成します。
+        Timer(double aLimitSec, TimerMode aMode = TimerMode_ProcessCpu); ///< 制限時間を定めてインスタンスを生成します。
 
+        void setMode(TimerMode aMode);      ///< 計測する時間の種類を設定します。
+        TimerMode mode()const;             ///< 計測する時間の種類を取得します。
         void start();                       ///< タイマーを開始します。
         bool isInTime()const;              ///< 制限時間内かどうかを返します。
         double pastSecForPrint()const;     ///< 表示用の経過時間を取得します。
+        double pastSec()const;             ///< 経過時間を取得します。
+        double limitSec()const;            ///< 制限時間を取得します。
+
+        static const char* ModeName(TimerMode aMode); ///< 計測する時間の種類の名前を取得します。
 
     private:
-        double pastSec()const;             ///< 経過時間を取得します。
+        int64_t currentNanoSec()const;     ///< 現在の時刻をナノ秒で取得します。
 
-        const int mLimitSec;                ///< 制限時間
-        std::clock_t mTimeBegin;            ///< 開始時刻
+        const double mLimitSec;             ///< 制限時間
+        TimerMode mMode;                    ///< 計測する時間の種類
+        int64_t mTimeBegin;                 ///< 開始時刻[ナノ秒]
+#if !defined(_WIN32)
+        clockid_t mThreadClock;             ///< start を呼んだスレッドの CPU 時計
+#endif
     };
 }
 //------------------------------------------------------------------------------
@@ -0,0 +1,168 @@
+//------------------------------------------------------------------------------
+/// @file
+/// @brief HPCTrace.hpp の実装
+/// @author ハル研究所プログラミングコンテスト実行委員会
+///
+/// @copyright  Copyright (c) 2015 HAL Laboratory, Inc.
+/// @attention  このファイルの利用は、同梱のREADMEにある
+///             利用条件に従ってください
+
+//------------------------------------------------------------------------------
+
+#include "HPCTrace.hpp"
+
+#include <cstdio>
+#include <mutex>
+#include <vector>
+#include "HPCCommon.hpp"
+#include "HPCMemory.hpp"
+#include "HPCTimer.hpp"
+
+namespace {
+
+    /// 記録する区間。
+    struct TraceEvent {
+        const char* name;       ///< 名前
+        const char* category;   ///< 分類
+        int64_t begin;          ///< 開始時刻[ナノ秒]
+        int64_t end;            ///< 終了時刻[ナノ秒]
+        int arg;                ///< 付加情報
+    };
+
+    /// スレッドごとのリングバッファ。書き込むのは持ち主のスレッドだけです。
+    struct TraceBuffer {
+        static const int Capacity = 1 << 14;    ///< 保持する区間の数
+
+        TraceEvent events[Capacity];            ///< 区間(count を Capacity で割った余りの位置に書く)
+        std::atomic<uint64_t> count;            ///< これまでに書いた区間の数
+        int threadId;                           ///< 表示用のスレッド番号
+        const char* threadName;                 ///< 表示用のスレッド名
+    };
+
+    std::mutex sBuffersMutex;                   ///< sBuffers への登録を守るロック(スレッドごとに 1 回だけ取る)
+    std::vector<TraceBuffer*> sBuffers;         ///< 全スレッドのバッファ
+    std::FILE* sFile = 0;                       ///< 出力先
+    hpc::Timer sClock(0, hpc::TimerMode_Wall);  ///< 記録に使う時計
+    thread_local TraceBuffer* tBuffer = 0;      ///< 呼び出したスレッドのバッファ
+
+    //------------------------------------------------------------------------------
+    /// 呼び出したスレッドのバッファを返します。初めて呼ばれたときに作って登録します。
+    ///
+    /// バッファは Close 後も解放しません。スレッドが終わった後もそのスレッドの区間を書き出すためです。
+    TraceBuffer& GetBuffer()
+    {
+        if (tBuffer == 0) {
+            HPC_MEMORY_TAG_SCOPE(hpc::MemoryTag_Trace);
+            TraceBuffer* buffer = new TraceBuffer();
+            buffer->count.store(0, std::memory_order_relaxed);
+            buffer->threadName = 0;
+            std::lock_guard<std::mutex> lock(sBuffersMutex);
+            buffer->threadId = static_cast<int>(sBuffers.size()) + 1;
+            sBuffers.push_back(buffer);
+            tBuffer = buffer;
+        }
+        return *tBuffer;
+    }
+}
+
+namespace hpc {
+
+    std::atomic<bool> Trace::sIsEnabled(false);
+
+    //------------------------------------------------------------------------------
+    /// 記録を開始します。呼び出したスレッドを "main" として表示します。
+    ///
+    /// @param[in] aPath 出力先のファイルパス。
+    ///
+    /// @return 開けたら @c true 。
+    bool Trace::Open(const char* aPath)
+    {
+        Close();
+        sFile = std::fopen(aPath, "w");
+        if (sFile == 0) {
+            return false;
+        }
+        sClock.start();
+        sIsEnabled.store(true, std::memory_order_release);
+        SetThreadName("main");
+        return true;
+    }
+
+    //------------------------------------------------------------------------------
+    /// 記録を終了し、全スレッドのバッファをファイルへ書き出します。
+    ///
+    /// 記録中のスレッドがないとき(各スレッドの終了後)に呼んでください。
+    void Trace::Close()
+    {
+        sIsEnabled.store(false, std::memory_order_release);
+        if (sFile == 0) {
+            return;
+        }
+        std::lock_guard<std::mutex> lock(sBuffersMutex);
+        HPC_FPRINT(sFile, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+        bool isFirst = true;
+        for (size_t i = 0; i < sBuffers.size(); ++i) {
+            const TraceBuffer& buffer = *sBuffers[i];
+            if (buffer.threadName != 0) {
+                HPC_FPRINT(sFile, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"%s\"}}",
+                    isFirst ? "" : ",\n", buffer.threadId, buffer.threadName);
+                isFirst = false;
+            }
+            const uint64_t count = buffer.count.load(std::memory_order_acquire);
+            const uint64_t first = count > static_cast<uint64_t>(TraceBuffer::Capacity) ? count - TraceBuffer::Capacity : 0;
+            for (uint64_t j = first; j < count; ++j) {
+                const TraceEvent& event = buffer.events[j % TraceBuffer::Capacity];
+                HPC_FPRINT(sFile, "%s{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%d,\"args\":{\"arg\":%d}}",
+                    isFirst ? "" : ",\n", event.name, event.category, event.begin / 1e3, (event.end - event.begin) / 1e3, buffer.threadId, event.arg);
+                isFirst = false;
+            }
+            sBuffers[i]->count.store(0, std::memory_order_relaxed);
+        }
+        HPC_FPRINT(sFile, "\n]}\n");
+        std::fclose(sFile);
+        sFile = 0;
+    }
+
+    //------------------------------------------------------------------------------
+    /// 記録に使う現在時刻を返します。
+    ///
+    /// @return Open してからの実時間[ナノ秒]。
+    int64_t Trace::NowNanoSec()
+    {
+        return static_cast<int64_t>(sClock.pastSec() * 1e9);
+    }
+
+    //------------------------------------------------------------------------------
+    /// 呼び出したスレッドの表示名を設定します。記録中でなければ何もしません。
+    ///
+    /// @param[in] aName 表示名(文字列リテラル)。
+    void Trace::SetThreadName(const char* aName)
+    {
+        if (IsEnabled()) {
+            GetBuffer().threadName = aName;
+        }
+    }
+
+    //------------------------------------------------------------------------------
+    /// 区間を 1 つ記録します。
+    ///
+    /// @param[in] aName 名前(文字列リテラル)。
+    /// @param[in] aCategory 分類(文字列リテラル)。
+    /// @param[in] aBeginNanoSec 開始時刻[ナノ秒]。
+    /// @param[in] aEndNanoSec 終了時刻[ナノ秒]。
+    /// @param[in] aArg 付加情報。
+    void Trace::Add(const char* aName, const char* aCategory, int64_t aBeginNanoSec, int64_t aEndNanoSec, int aArg)
+    {
+        TraceBuffer& buffer = GetBuffer();
+        const uint64_t count = buffer.count.load(std::memory_order_relaxed);
+        TraceEvent& event = buffer.events[count % TraceBuffer::Capacity];
+        event.name = aName;
+        event.category = aCategory;
+        event.begin = aBeginNanoSec;
+        event.end = aEndNanoSec;
+        event.arg = aArg;
+        buffer.count.store(count + 1, std::memory_order_release);
+    }
+}
+//------------------------------------------------------------------------------
+// EOF
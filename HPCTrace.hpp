@@ -0,0 +1,87 @@
+//------------------------------------------------------------------------------
+/// @file
+/// @brief Trace クラス
+/// @author ハル研究所プログラミングコンテスト実行委員会
+///
+/// @copyright  Copyright (c) 2015 HAL Laboratory, Inc.
+/// @attention  このファイルの利用は、同梱のREADMEにある
+///             利用条件に従ってください
+
+//------------------------------------------------------------------------------
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+namespace hpc {
+
+    //------------------------------------------------------------------------------
+    /// 処理の区間を記録し、Chrome / Perfetto で読める trace event 形式の JSON に書き出します。
+    ///
+    /// 区間はスレッドごとのリングバッファに書き込まれます。書き込むスレッドは
+    /// バッファの持ち主だけなのでロックは取りません。バッファが一杯になると古いものから上書きします。
+    /// Close でまとめてファイルへ書き出します。
+    ///
+    /// Open するまでは無効で、HPC_TRACE_SCOPE はフラグを 1 つ読むだけです。
+    class Trace
+    {
+    public:
+        static bool Open(const char* aPath);                ///< 記録を開始します。
+        static void Close();                                ///< 記録を終了し、ファイルへ書き出します。
+        static bool IsEnabled();                            ///< 記録中かどうかを返します。
+        static int64_t NowNanoSec();                        ///< 記録に使う現在時刻を返します。
+        static void SetThreadName(const char* aName);       ///< 呼び出したスレッドの表示名を設定します。
+        static void Add(const char* aName, const char* aCategory, int64_t aBeginNanoSec, int64_t aEndNanoSec, int aArg); ///< 区間を 1 つ記録します。
+
+    private:
+        Trace();
+
+        static std::atomic<bool> sIsEnabled;                ///< 記録中か
+    };
+
+    //------------------------------------------------------------------------------
+    /// 生成から破棄までを 1 つの区間として記録します。
+    class TraceScope
+    {
+    public:
+        TraceScope(const char* aName, const char* aCategory, int aArg)
+            : mName(aName)
+            , mCategory(aCategory)
+            , mArg(aArg)
+            , mBegin(Trace::IsEnabled() ? Trace::NowNanoSec() : -1)
+        {
+        }
+
+        ~TraceScope()
+        {
+            if (mBegin >= 0 && Trace::IsEnabled()) {
+                Trace::Add(mName, mCategory, mBegin, Trace::NowNanoSec(), mArg);
+            }
+        }
+
+    private:
+        TraceScope(const TraceScope&);
+        TraceScope& operator=(const TraceScope&);
+
+        const char* const mName;        ///< 区間の名前(文字列リテラル)
+        const char* const mCategory;    ///< 区間の分類(文字列リテラル)
+        const int mArg;                 ///< 付加情報(ステージ番号など)
+        const int64_t mBegin;           ///< 開始時刻[ナノ秒]。記録していなければ -1
+    };
+
+    //------------------------------------------------------------------------------
+    /// @return Open してから Close するまでは @c true 。
+    inline bool Trace::IsEnabled()
+    {
+        return sIsEnabled.load(std::memory_order_relaxed);
+    }
+}
+
+#define HPC_TRACE_CONCAT_IMPL(a, b) a##b
+#define HPC_TRACE_CONCAT(a, b) HPC_TRACE_CONCAT_IMPL(a, b)
+
+/// このスコープの終わりまでを区間 aName として記録します。aName と aCategory は文字列リテラルにしてください。
+#define HPC_TRACE_SCOPE(aName, aCategory, aArg) \
+    ::hpc::TraceScope HPC_TRACE_CONCAT(hpcTraceScope, __LINE__)(aName, aCategory, aArg)
+//------------------------------------------------------------------------------
+// EOF
@@ -0,0 +1,445 @@
+//------------------------------------------------------------------------------
+/// @file
+/// @brief    解答を比べる A/B テスト用の main 関数
+/// @author   ハル研究所プログラミングコンテスト実行委員会
+///
+/// @copyright  Copyright (c) 2015 HAL Laboratory, Inc.
+/// @attention  このファイルの利用は、同梱のREADMEにある
+///             利用条件に従ってください
+
+//------------------------------------------------------------------------------
+
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+#include "HPCCommon.hpp"
+#include "HPCLevelDesigner.hpp"
+#include "HPCParameter.hpp"
+#include "HPCRandom.hpp"
+
+//------------------------------------------------------------------------------
+namespace {
+    using namespace hpc;
+
+    const int DefaultSeedCount = 8;             ///< シードを指定しなかったときに作るシードの数
+    const int DefaultRepeatCount = 1;           ///< 繰り返し回数を指定しなかったときの回数
+    const int DefaultJobCount = 1;              ///< 同時に実行する数を指定しなかったときの数(並列だと初期化時間が互いに干渉する)
+    const double SignificanceLevel = 0.05;      ///< 有意とみなす p 値
+    const int ListedStageMax = 10;              ///< 差が有意なステージを表示する最大数
+    const char* const RunDirectory = "ab/runs"; ///< 各実行の指標の出力先
+
+    /// 1 つのステージの結果(繰り返した分の合計)
+    struct StageResult {
+        int runCount;           ///< 実行回数
+        int completeCount;      ///< 完了した回数
+        double fuel;            ///< 完了したときの燃料の合計
+        double score;           ///< 得点の合計
+        double solveMs;         ///< 解答の初期化時間の合計[ミリ秒]
+    };
+
+    /// [解答][シード][ステージ] の結果
+    typedef std::vector<std::vector<std::vector<StageResult> > > ResultTable;
+
+    /// 対応のある t 検定の結果
+    struct PairedTest {
+        int count;              ///< 組の数
+        double meanDiff;        ///< 差の平均
+        double p;               ///< 両側 p 値
+    };
+
+    /// 差の種類
+    enum DiffKind {
+        DiffKind_Fuel,
+        DiffKind_Score,
+        DiffKind_SolveMs,
+        DiffKind_TERM
+    };
+
+    //------------------------------------------------------------------------------
+    /// 不完全ベータ関数の連分数を評価します。
+    double BetaContinuedFraction(double aA, double aB, double aX)
+    {
+        const int IterationMax = 300;
+        const double Epsilon = 3e-14;
+        const double Tiny = 1e-300;
+        double c = 1.0;
+        double d = 1.0 - (aA + aB) * aX / (aA + 1.0);
+        d = 1.0 / (std::fabs(d) < Tiny ? Tiny : d);
+        double h = d;
+        for (int m = 1; m <= IterationMax; ++m) {
+            const double m2 = 2.0 * m;
+            double aa = m * (aB - m) * aX / ((aA - 1.0 + m2) * (aA + m2));
+            d = 1.0 + aa * d;
+            d = 1.0 / (std::fabs(d) < Tiny ? Tiny : d);
+            c = 1.0 + aa / c;
+            c = std::fabs(c) < Tiny ? Tiny : c;
+            h *= d * c;
+            aa = -(aA + m) * (aA + aB + m) * aX / ((aA + m2) * (aA + 1.0 + m2));
+            d = 1.0 + aa * d;
+            d = 1.0 / (std::fabs(d) < Tiny ? Tiny : d);
+            c = 1.0 + aa / c;
+            c = std::fabs(c) < Tiny ? Tiny : c;
+            const double delta = d * c;
+            h *= delta;
+            if (std::fabs(delta - 1.0) < Epsilon) {
+                break;
+            }
+        }
+        return h;
+    }
+
+    //------------------------------------------------------------------------------
+    /// @return 正則化不完全ベータ関数 I_x(a, b) 。
+    double RegularizedIncompleteBeta(double aA, double aB, double aX)
+    {
+        if (aX <= 0.0) {
+            return 0.0;
+        }
+        if (aX >= 1.0) {
+            return 1.0;
+        }
+        const double front = std::exp(std::lgamma(aA + aB) - std::lgamma(aA) - std::lgamma(aB) + aA * std::log(aX) + aB * std::log(1.0 - aX));
+        if (aX < (aA + 1.0) / (aA + aB + 2.0)) {
+            return front * BetaContinuedFraction(aA, aB, aX) / aA;
+        }
+        return 1.0 - front * BetaContinuedFraction(aB, aA, 1.0 - aX) / aB;
+    }
+
+    //------------------------------------------------------------------------------
+    /// 差の平均が 0 であるかを、対応のある t 検定で調べます。
+    ///
+    /// @param[in] aDiffs 組ごとの差。
+    ///
+    /// @return 検定の結果。組が 2 つ未満なら p は 1 。
+    PairedTest TestPaired(const std::vector<double>& aDiffs)
+    {
+        PairedTest result = { static_cast<int>(aDiffs.size()), 0.0, 1.0 };
+        if (aDiffs.empty()) {
+            return result;
+        }
+        double sum = 0.0;
+        for (size_t i = 0; i < aDiffs.size(); ++i) {
+            sum += aDiffs[i];
+        }
+        result.meanDiff = sum / aDiffs.size();
+        if (aDiffs.size() < 2) {
+            return result;
+        }
+        double squareSum = 0.0;
+        for (size_t i = 0; i < aDiffs.size(); ++i) {
+            squareSum += (aDiffs[i] - result.meanDiff) * (aDiffs[i] - result.meanDiff);
+        }
+        const double degree = static_cast<double>(aDiffs.size() - 1);
+        const double standardError = std::sqrt(squareSum / degree / aDiffs.size());
+        if (standardError == 0.0) {
+            result.p = result.meanDiff == 0.0 ? 1.0 : 0.0;
+            return result;
+        }
+        const double t = result.meanDiff / standardError;
+        result.p = RegularizedIncompleteBeta(degree / 2.0, 0.5, degree / (degree + t * t));
+        return result;
+    }
+
+    //------------------------------------------------------------------------------
+    /// 指標の CSV (Metrics の出力)からステージの行を読み、結果に足し込みます。
+    ///
+    /// @return 読めたら @c true 。
+    bool ReadMetrics(const char* aPath, std::vector<StageResult>& aStages)
+    {
+        std::FILE* file = std::fopen(aPath, "r");
+        if (file == 0) {
+            return false;
+        }
+        char line[512];
+        int stageCount = 0;
+        while (std::fgets(line, sizeof(line), file) != 0) {
+            int stage, category, wall, period, item, width, height, stages, completed;
+            long long turns, fuel, score;
+            double solveMs;
+            if (std::sscanf(line, "stage,%d,%d,%d,%d,%d,%d,%d,%d,%d,%lld,%lld,%lld,%lf",
+                    &stage, &category, &wall, &period, &item, &width, &height, &stages, &completed,
+                    &turns, &fuel, &score, &solveMs) != 13 || stage < 0 || Parameter::GameStageCount <= stage) {
+                continue;
+            }
+            StageResult& result = aStages[stage];
+            ++result.runCount;
+            if (completed != 0) {
+                ++result.completeCount;
+                result.fuel += fuel;
+            }
+            result.score += score;
+            result.solveMs += solveMs;
+            ++stageCount;
+        }
+        std::fclose(file);
+        return stageCount == Parameter::GameStageCount;
+    }
+
+    //------------------------------------------------------------------------------
+    /// コマンドを aJobCount 個ずつ並列に実行します。
+    ///
+    /// @return 全て成功したら @c true 。
+    bool RunCommands(const std::vector<std::string>& aCommands, int aJobCount)
+    {
+        std::atomic<size_t> next(0);
+        std::atomic<bool> isSucceeded(true);
+        std::vector<std::thread> workers;
+        for (int i = 0; i < aJobCount; ++i) {
+            workers.push_back(std::thread([&]() {
+                for (size_t index = next++; index < aCommands.size(); index = next++) {
+                    if (std::system(aCommands[index].c_str()) != 0) {
+                        isSucceeded = false;
+                    }
+                }
+            }));
+        }
+        for (size_t i = 0; i < workers.size(); ++i) {
+            workers[i].join();
+        }
+        return isSucceeded;
+    }
+
+    //------------------------------------------------------------------------------
+    /// 2 つの解答の、あるステージの差を返します。どちらかが完了していなければ燃料の差はありません。
+    ///
+    /// @return 差があれば @c true 。
+    bool StageDiff(const StageResult& aBase, const StageResult& aCandidate, DiffKind aKind, double& aDiff)
+    {
+        switch (aKind) {
+        case DiffKind_Fuel:
+            if (aBase.completeCount == 0 || aCandidate.completeCount == 0) {
+                return false;
+            }
+            aDiff = aCandidate.fuel / aCandidate.completeCount - aBase.fuel / aBase.completeCount;
+            return true;
+        case DiffKind_Score:
+            aDiff = aCandidate.score / aCandidate.runCount - aBase.score / aBase.runCount;
+            return true;
+        case DiffKind_SolveMs:
+            aDiff = aCandidate.solveMs / aCandidate.runCount - aBase.solveMs / aBase.runCount;
+            return true;
+        default:
+            HPC_SHOULD_NOT_REACH_HERE();
+            return false;
+        }
+    }
+
+    //------------------------------------------------------------------------------
+    /// 差の平均と p 値を 1 列分表示します。有意なら * を付けます。
+    void PrintTest(const PairedTest& aTest)
+    {
+        HPC_PRINT(" %11.3f %7.4f%s", aTest.meanDiff, aTest.p, aTest.p < SignificanceLevel ? "*" : " ");
+    }
+
+    //------------------------------------------------------------------------------
+    /// @return パスからディレクトリと拡張子を除いた名前。
+    std::string VariantName(const char* aPath)
+    {
+        std::string name(aPath);
+        const size_t slash = name.find_last_of('/');
+        if (slash != std::string::npos) {
+            name = name.substr(slash + 1);
+        }
+        const size_t dot = name.find_last_of('.');
+        return dot == std::string::npos ? name : name.substr(0, dot);
+    }
+}
+
+//------------------------------------------------------------------------------
+/// A/B テストのエントリポイントです。
+///
+/// 解答ごとにビルドした実行ファイル(make ab で ab/hpc2015_*.exe に作られます)を、
+/// 同じシードの組で並列に実行し、最初の解答(基準)と他の解答をステージごとに比べます。
+/// 燃料・得点・解答の初期化時間の差を、シードとステージの組についての対応のある t 検定で調べ、
+/// 全体とステージの種類ごと、およびシードをまたいで差が有意なステージを表示します。
+///
+///   オプション   | 説明
+///  --------------|----------------------------------------------
+///   -seed x,y,z,w | ステージを生成する乱数のシードを追加します。(複数指定可)
+///   -n count     | シードを指定しなかったときに作るシードの数を指定します。(既定は 8)
+///   -r count     | シードごとの繰り返し回数を指定します。(既定は 1 。時間の差を見るときは増やしてください)
+///   -j count     | 同時に実行する数を指定します。(既定は 1 。2 以上では初期化時間が互いに干渉するので、時間の差では失敗にしません)
+///
+/// 例: ab/hpc2015_compare.exe -n 16 ab/hpc2015_160104_0200.exe ab/hpc2015_current.exe
+///
+/// @return 基準より得点が有意に下がるか、(-j 1 のとき)初期化時間が有意に増えた解答があれば 1 、
+///         なければ 0 、引数が不正なら 2 を返します。
+int main(int argc, const char* argv[])
+{
+    std::vector<std::vector<uint> > seeds;
+    int seedCount = DefaultSeedCount;
+    int repeatCount = DefaultRepeatCount;
+    int jobCount = DefaultJobCount;
+    std::vector<const char*> variants;
+    for (int i = 1; i < argc; ++i) {
+        if (!std::strcmp(argv[i], "-seed") && i + 1 < argc) {
+            std::vector<uint> seed(Random::SeedCount);
+            if (!Random::ParseSeeds(argv[++i], &seed[0])) {
+                HPC_PRINT("Invalid Argument: %s is not a seed (x,y,z,w).\n", argv[i]);
+                return 2;
+            }
+            seeds.push_back(seed);
+        }
+        else if ((!std::strcmp(argv[i], "-n") || !std::strcmp(argv[i], "-r") || !std::strcmp(argv[i], "-j")) && i + 1 < argc) {
+            const int value = std::atoi(argv[i + 1]);
+            if (value <= 0) {
+                HPC_PRINT("Invalid Argument: %s needs a positive count.\n", argv[i]);
+                return 2;
+            }
+            (argv[i][1] == 'n' ? seedCount : argv[i][1] == 'r' ? repeatCount : jobCount) = value;
+            ++i;
+        }
+        else if (argv[i][0] == '-') {
+            HPC_PRINT("Invalid Argument: %s is unknown command.\n", argv[i]);
+            return 2;
+        }
+        else {
+            variants.push_back(argv[i]);
+        }
+    }
+    if (variants.size() < 2) {
+        HPC_PRINT("Usage: %s [-seed x,y,z,w]... [-n seeds] [-r repeat] [-j jobs] baseline.exe candidate.exe...\n", argv[0]);
+        return 2;
+    }
+    if (seeds.empty()) {
+        Random random;
+        for (int i = 0; i < seedCount; ++i) {
+            std::vector<uint> seed(Random::SeedCount);
+            for (int j = 0; j < Random::SeedCount; ++j) {
+                seed[j] = static_cast<uint>(random.randMinMax(1, INT_MAX));
+            }
+            seeds.push_back(seed);
+        }
+    }
+
+    // 全ての (解答, シード, 繰り返し) を並列に実行する。
+    std::string mkdirCommand = std::string("mkdir -p ") + RunDirectory;
+    if (std::system(mkdirCommand.c_str()) != 0) {
+        HPC_PRINT("Cannot create %s.\n", RunDirectory);
+        return 2;
+    }
+    std::vector<std::string> commands;
+    std::vector<std::string> metricsPaths;
+    for (size_t v = 0; v < variants.size(); ++v) {
+        for (size_t s = 0; s < seeds.size(); ++s) {
+            for (int r = 0; r < repeatCount; ++r) {
+                char path[256];
+                std::snprintf(path, sizeof(path), "%s/v%d_s%d_r%d.csv", RunDirectory, static_cast<int>(v), static_cast<int>(s), r);
+                char command[1024];
+                std::snprintf(command, sizeof(command), "'%s' -n -seed %u,%u,%u,%u -m %s > /dev/null",
+                    variants[v], seeds[s][0], seeds[s][1], seeds[s][2], seeds[s][3], path);
+                commands.push_back(command);
+                metricsPaths.push_back(path);
+            }
+        }
+    }
+    HPC_PRINT("Running %d variants x %d seeds x %d repeats on %d jobs...\n",
+        static_cast<int>(variants.size()), static_cast<int>(seeds.size()), repeatCount, jobCount);
+    if (!RunCommands(commands, jobCount)) {
+        HPC_PRINT("Some runs failed.\n");
+        return 2;
+    }
+
+    const StageResult emptyResult = { 0, 0, 0.0, 0.0, 0.0 };
+    ResultTable results(variants.size(), std::vector<std::vector<StageResult> >(seeds.size(), std::vector<StageResult>(Parameter::GameStageCount, emptyResult)));
+    for (size_t v = 0, run = 0; v < variants.size(); ++v) {
+        for (size_t s = 0; s < seeds.size(); ++s) {
+            for (int r = 0; r < repeatCount; ++r, ++run) {
+                if (!ReadMetrics(metricsPaths[run].c_str(), results[v][s])) {
+                    HPC_PRINT("Cannot read %s.\n", metricsPaths[run].c_str());
+                    return 2;
+                }
+            }
+        }
+    }
+
+    // 基準と各解答を比べる。
+    static const char* const DiffNames[DiffKind_TERM] = { "dFuel", "dScore", "dSolveMs" };
+    bool hasRegression = false;
+    for (size_t v = 1; v < variants.size(); ++v) {
+        HPC_PRINT("\n%s vs %s (baseline), * : p < %.2f\n", VariantName(variants[v]).c_str(), VariantName(variants[0]).c_str(), SignificanceLevel);
+        HPC_PRINT("%-20s %6s", "Category", "Pairs");
+        for (int kind = 0; kind < DiffKind_TERM; ++kind) {
+            HPC_PRINT(" %11s %8s", DiffNames[kind], "p");
+        }
+        HPC_PRINT("\n");
+
+        PairedTest overall[DiffKind_TERM];
+        for (int category = 0; category <= LevelDesigner::CategoryCount; ++category) {
+            const bool isOverall = category == LevelDesigner::CategoryCount;
+            HPC_PRINT("%-20s %6d", isOverall ? "total" : LevelDesigner::CategoryLabel(category),
+                static_cast<int>(seeds.size()) * (isOverall ? Parameter::GameStageCount : Parameter::GameStageCount / LevelDesigner::CategoryCount));
+            for (int kind = 0; kind < DiffKind_TERM; ++kind) {
+                std::vector<double> diffs;
+                for (size_t s = 0; s < seeds.size(); ++s) {
+                    for (int stage = 0; stage < Parameter::GameStageCount; ++stage) {
+                        double diff = 0.0;
+                        if ((isOverall || LevelDesigner::Category(stage) == category)
+                            && StageDiff(results[0][s][stage], results[v][s][stage], static_cast<DiffKind>(kind), diff)) {
+                            diffs.push_back(diff);
+                        }
+                    }
+                }
+                const PairedTest test = TestPaired(diffs);
+                PrintTest(test);
+                if (isOverall) {
+                    overall[kind] = test;
+                }
+            }
+            HPC_PRINT("\n");
+        }
+
+        // シードをまたいで得点の差が有意なステージを、p の小さい順に表示する。
+        std::vector<std::pair<double, int> > significantStages;
+        for (int stage = 0; stage < Parameter::GameStageCount; ++stage) {
+            std::vector<double> diffs;
+            for (size_t s = 0; s < seeds.size(); ++s) {
+                double diff = 0.0;
+                StageDiff(results[0][s][stage], results[v][s][stage], DiffKind_Score, diff);
+                diffs.push_back(diff);
+            }
+            const PairedTest test = TestPaired(diffs);
+            if (test.p < SignificanceLevel) {
+                significantStages.push_back(std::make_pair(test.p, stage));
+            }
+        }
+        std::sort(significantStages.begin(), significantStages.end());
+        HPC_PRINT("Stages with a significant score difference across seeds: %d\n", static_cast<int>(significantStages.size()));
+        for (int i = 0; i < static_cast<int>(significantStages.size()) && i < ListedStageMax; ++i) {
+            const int stage = significantStages[i].second;
+            std::vector<double> diffs;
+            for (size_t s = 0; s < seeds.size(); ++s) {
+                double diff = 0.0;
+                StageDiff(results[0][s][stage], results[v][s][stage], DiffKind_Score, diff);
+                diffs.push_back(diff);
+            }
+            HPC_PRINT("  stage %3d %-20s dScore %11.1f p %.4f\n", stage, LevelDesigner::CategoryLabel(LevelDesigner::Category(stage)),
+                TestPaired(diffs).meanDiff, significantStages[i].first);
+        }
+
+        if (overall[DiffKind_Score].p < SignificanceLevel && overall[DiffKind_Score].meanDiff < 0.0) {
+            HPC_PRINT("REGRESSION: score is significantly lower.\n");
+            hasRegression = true;
+        }
+        if (overall[DiffKind_SolveMs].p < SignificanceLevel && overall[DiffKind_SolveMs].meanDiff > 0.0) {
+            if (jobCount == 1) {
+                HPC_PRINT("REGRESSION: solve time is significantly longer.\n");
+                hasRegression = true;
+            }
+            else {
+                HPC_PRINT("NOTE: solve time is significantly longer, but runs were parallel (-j %d). Rerun with -j 1 to check.\n", jobCount);
+            }
+        }
+    }
+    return hasRegression ? 1 : 0;
+}
+
+//------------------------------------------------------------------------------
+// EOF
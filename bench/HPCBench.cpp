@@ -0,0 +1,205 @@
+//------------------------------------------------------------------------------
+/// @file
+/// @brief    ベンチマーク用の main 関数
+/// @author   ハル研究所プログラミングコンテスト実行委員会
+///
+/// @copyright  Copyright (c) 2015 HAL Laboratory, Inc.
+/// @attention  このファイルの利用は、同梱のREADMEにある
+///             利用条件に従ってください
+
+//------------------------------------------------------------------------------
+
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include "HPCCommon.hpp"
+#include "HPCProfiler.hpp"
+#include "HPCRandom.hpp"
+#include "HPCSimulation.hpp"
+#include "HPCTimer.hpp"
+
+//------------------------------------------------------------------------------
+namespace {
+    using namespace hpc;
+
+    /// ステージを生成する乱数のシード
+    struct Seed {
+        uint x;
+        uint y;
+        uint z;
+        uint w;
+    };
+
+    /// シードを指定しなかったときに使うシード。先頭は Random の既定のシード。
+    const Seed DefaultSeeds[] = {
+        { 0x31f9f4c6, 0xc7871429, 0x492f765a, 0xa3a3992f },
+        { 0x12345678, 0x9abcdef0, 0x0fedcba9, 0x87654321 },
+        { 0x2545f491, 0x4f6cdd1d, 0x9e3779b9, 0x7f4a7c15 },
+        { 0xdeadbeef, 0xcafebabe, 0x8badf00d, 0xfeedface },
+    };
+
+    /// 繰り返し回数を指定しなかったときの回数。
+    const int DefaultRepeatCount = 3;
+
+    /// 平均と標準偏差を求めるための集計
+    class Stat
+    {
+    public:
+        Stat()
+            : mValues()
+        {
+        }
+
+        void add(double aValue)
+        {
+            mValues.push_back(aValue);
+        }
+
+        double mean()const
+        {
+            double sum = 0.0;
+            for (size_t i = 0; i < mValues.size(); ++i) {
+                sum += mValues[i];
+            }
+            return mValues.empty() ? 0.0 : sum / mValues.size();
+        }
+
+        /// 標本標準偏差。値が 1 つ以下なら 0 。
+        double stddev()const
+        {
+            if (mValues.size() < 2) {
+                return 0.0;
+            }
+            const double average = mean();
+            double sum = 0.0;
+            for (size_t i = 0; i < mValues.size(); ++i) {
+                sum += (mValues[i] - average) * (mValues[i] - average);
+            }
+            return std::sqrt(sum / (mValues.size() - 1));
+        }
+
+    private:
+        std::vector<double> mValues;
+    };
+
+    /// 1 つのシード(または全体)の集計
+    struct Summary {
+        Stat score;                         ///< 得点
+        Stat timeSec;                       ///< ゲームの時間(表示と同じ、プロセスの CPU 時間)[秒]
+        Stat wallSec;                       ///< 実時間[秒]
+        Stat phaseSec[ProfilePhase_TERM];   ///< 処理の区分ごとの時間[秒]
+    };
+
+    //------------------------------------------------------------------------------
+    /// 平均と標準偏差を JSON で出力します。
+    void PrintStat(const char* aName, const Stat& aStat)
+    {
+        HPC_PRINT("\"%s\":{\"mean\":%.6f,\"stddev\":%.6f}", aName, aStat.mean(), aStat.stddev());
+    }
+
+    //------------------------------------------------------------------------------
+    /// 集計を JSON のメンバとして出力します。
+    void PrintSummary(const Summary& aSummary)
+    {
+        PrintStat("score", aSummary.score);
+        HPC_PRINT(",");
+        PrintStat("timeSec", aSummary.timeSec);
+        HPC_PRINT(",");
+        PrintStat("wallSec", aSummary.wallSec);
+        HPC_PRINT(",\"phaseSec\":{");
+        for (int phase = 0; phase < ProfilePhase_TERM; ++phase) {
+            if (phase != 0) {
+                HPC_PRINT(",");
+            }
+            PrintStat(Profiler::PhaseName(static_cast<ProfilePhase>(phase)), aSummary.phaseSec[phase]);
+        }
+        HPC_PRINT("}");
+    }
+
+    //------------------------------------------------------------------------------
+    /// ゲーム全体を 1 回実行し、結果を集計に加えます。
+    void RunOnce(const Seed& aSeed, Summary& aSeedSummary, Summary& aOverall)
+    {
+        // Simulation は全ステージの記録を持ち大きいので、実行ごとにヒープに作る。
+        Simulation* simulation = new Simulation(Random(aSeed.x, aSeed.y, aSeed.z, aSeed.w));
+        Profiler::Reset();
+        Timer wallTimer(0, TimerMode_Wall);
+        wallTimer.start();
+        simulation->run();
+        const double wallSec = wallTimer.pastSec();
+
+        Summary* summaries[] = { &aSeedSummary, &aOverall };
+        for (int i = 0; i < 2; ++i) {
+            summaries[i]->score.add(simulation->score());
+            summaries[i]->timeSec.add(simulation->pastTimeSecForPrint());
+            summaries[i]->wallSec.add(wallSec);
+            for (int phase = 0; phase < ProfilePhase_TERM; ++phase) {
+                summaries[i]->phaseSec[phase].add(Profiler::TotalNanoSec(static_cast<ProfilePhase>(phase)) / 1e9);
+            }
+        }
+        delete simulation;
+    }
+}
+
+//------------------------------------------------------------------------------
+/// ベンチマークのエントリポイントです。
+///
+/// シードごとにゲーム全体を繰り返し実行し、得点・時間・処理の区分ごとの時間の
+/// 平均と標準偏差を JSON で標準出力に書きます。
+///
+///   オプション   | 説明
+///  --------------|----------------------------------------------
+///   -seed x,y,z,w | ステージを生成する乱数のシードを追加します。(複数指定可。省略時は既定の 4 つ)
+///   -r count     | シードごとの繰り返し回数を指定します。(既定は 3)
+///
+/// @return 正常に終了したら 0 、引数が不正なら 1 を返します。
+int main(int argc, const char* argv[])
+{
+    std::vector<Seed> seeds;
+    int repeatCount = DefaultRepeatCount;
+    for (int i = 1; i < argc; ++i) {
+        if (!std::strcmp(argv[i], "-seed") && i + 1 < argc) {
+            uint values[Random::SeedCount];
+            if (!Random::ParseSeeds(argv[++i], values)) {
+                HPC_PRINT("Invalid Argument: %s is not a seed (x,y,z,w).\n", argv[i]);
+                return 1;
+            }
+            const Seed seed = { values[0], values[1], values[2], values[3] };
+            seeds.push_back(seed);
+        }
+        else if (!std::strcmp(argv[i], "-r") && i + 1 < argc) {
+            repeatCount = std::atoi(argv[++i]);
+            if (repeatCount <= 0) {
+                HPC_PRINT("Invalid Argument: -r needs a positive count.\n");
+                return 1;
+            }
+        }
+        else {
+            HPC_PRINT("Invalid Argument: %s is unknown command.\n", argv[i]);
+            return 1;
+        }
+    }
+    if (seeds.empty()) {
+        seeds.assign(DefaultSeeds, DefaultSeeds + sizeof(DefaultSeeds) / sizeof(DefaultSeeds[0]));
+    }
+
+    Summary overall;
+    HPC_PRINT("{\"repeat\":%d,\"profiled\":%s,\"seeds\":[", repeatCount, Profiler::IsEnabled() ? "true" : "false");
+    for (size_t s = 0; s < seeds.size(); ++s) {
+        Summary seedSummary;
+        for (int r = 0; r < repeatCount; ++r) {
+            RunOnce(seeds[s], seedSummary, overall);
+        }
+        HPC_PRINT("%s\n{\"seed\":[%u,%u,%u,%u],", s == 0 ? "" : ",", seeds[s].x, seeds[s].y, seeds[s].z, seeds[s].w);
+        PrintSummary(seedSummary);
+        HPC_PRINT("}");
+    }
+    HPC_PRINT("],\n\"overall\":{");
+    PrintSummary(overall);
+    HPC_PRINT("}}\n");
+    return 0;
+}
+
+//------------------------------------------------------------------------------
+// EOF
@@ -0,0 +1,331 @@
+//------------------------------------------------------------------------------
+/// @file
+/// @brief    ゲーム進行部分のマイクロベンチマーク用の main 関数
+/// @author   ハル研究所プログラミングコンテスト実行委員会
+///
+/// @copyright  Copyright (c) 2015 HAL Laboratory, Inc.
+/// @attention  このファイルの利用は、同梱のREADMEにある
+///             利用条件に従ってください
+
+//------------------------------------------------------------------------------
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include "HPCCommon.hpp"
+#include "HPCGame.hpp"
+#include "HPCLevelDesigner.hpp"
+#include "HPCRandom.hpp"
+#include "HPCRecord.hpp"
+#include "HPCSolver.hpp"
+#include "HPCStage.hpp"
+
+//------------------------------------------------------------------------------
+namespace {
+    using namespace hpc;
+
+    /// 繰り返し回数を指定しなかったときの回数。
+    const int DefaultRepeatCount = 5;
+
+    /// 計測する範囲
+    enum BenchMode {
+        BenchMode_RunTurn,          ///< Stage::start と Stage::runTurn だけ
+        BenchMode_RunTurnRecord,    ///< 上に加えて Record への書き込み
+        BenchMode_Game,             ///< Game 全体 (ステージの生成、指標や分析の呼び出しを含む)
+        BenchMode_TERM
+    };
+
+    /// 計測する範囲の名前
+    const char* const BenchModeNames[BenchMode_TERM] = {
+        "runTurn",
+        "runTurn+record",
+        "game",
+    };
+
+    /// 1 ステージ分の解答の出力
+    struct StageStream {
+        Random random;              ///< このステージを生成する直前の乱数の状態
+        std::vector<int> periodItems; ///< 時間帯ごとに積み込んだ荷物(ItemGroup のビットマスク)
+        std::vector<Action> actions;  ///< 各ターンの動作
+        int score;                  ///< 得点
+        int turns;                  ///< ターン数 (積み込みのターンを含む)
+    };
+
+    /// 記録中または再生中のステージ
+    StageStream* sStream = 0;
+    /// 再生中の時間帯と動作の位置
+    size_t sPeriodCursor = 0;
+    size_t sActionCursor = 0;
+    /// 記録中に呼び出す元の解答
+    const SolverEntry* sRecordedSolver = 0;
+
+    //------------------------------------------------------------------------------
+    /// @name 元の解答を呼び出し、その出力を sStream に記録する解答
+    //@{
+    void RecordInit(const Stage& aStage)
+    {
+        sRecordedSolver->init(aStage);
+    }
+
+    void RecordInitPeriod(const Stage& aStage, ItemGroup& aItemGroup)
+    {
+        sRecordedSolver->initPeriod(aStage, aItemGroup);
+        sStream->periodItems.push_back(aItemGroup.getBits());
+    }
+
+    Action RecordGetNextAction(const Stage& aStage)
+    {
+        const Action action = sRecordedSolver->getNextAction(aStage);
+        sStream->actions.push_back(action);
+        return action;
+    }
+
+    void RecordFinalizePeriod(const Stage& aStage, StageState aStageState, int aCost)
+    {
+        sRecordedSolver->finalizePeriod(aStage, aStageState, aCost);
+    }
+
+    void RecordFinalize(const Stage& aStage, StageState aStageState, int aScore)
+    {
+        sRecordedSolver->finalize(aStage, aStageState, aScore);
+    }
+    //@}
+
+    //------------------------------------------------------------------------------
+    /// @name sStream の出力をそのまま返す、何も考えない解答
+    //@{
+    void ReplayInit(const Stage&)
+    {
+        sPeriodCursor = 0;
+        sActionCursor = 0;
+    }
+
+    void ReplayInitPeriod(const Stage&, ItemGroup& aItemGroup)
+    {
+        aItemGroup.setBits(sStream->periodItems[sPeriodCursor++]);
+    }
+
+    Action ReplayGetNextAction(const Stage&)
+    {
+        return sStream->actions[sActionCursor++];
+    }
+
+    void ReplayFinalizePeriod(const Stage&, StageState, int)
+    {
+    }
+
+    void ReplayFinalize(const Stage&, StageState, int)
+    {
+    }
+    //@}
+
+    const SolverEntry RecordEntry = {
+        "record", "records the outputs of another solver",
+        &RecordInit, &RecordInitPeriod, &RecordGetNextAction, &RecordFinalizePeriod, &RecordFinalize,
+    };
+
+    const SolverEntry ReplayEntry = {
+        "replay", "replays recorded outputs",
+        &ReplayInit, &ReplayInitPeriod, &ReplayGetNextAction, &ReplayFinalizePeriod, &ReplayFinalize,
+    };
+
+    //------------------------------------------------------------------------------
+    /// @return 計測に使う現在時刻[ナノ秒]。
+    int64_t NowNanoSec()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    //------------------------------------------------------------------------------
+    /// 元の解答でステージを解き、出力を記録します。
+    ///
+    /// @param[in] aRandom    ステージを生成する乱数。
+    /// @param[in] aStageCount 記録するステージの数。
+    /// @param[out] aStreams  ステージごとの出力。
+    void RecordStreams(Random aRandom, int aStageCount, std::vector<StageStream>& aStreams)
+    {
+        sRecordedSolver = &Solver::Current();
+        Solver::Select(RecordEntry);
+        Stage* stage = new Stage();
+        aStreams.resize(aStageCount);
+        for (int i = 0; i < aStageCount; ++i) {
+            StageStream& stream = aStreams[i];
+            stream.random = aRandom;
+            LevelDesigner::Setup(i, *stage, aRandom);
+            sStream = &stream;
+            stage->start(true);
+            stream.turns = 0;
+            while (stage->lastTurnResult().state == StageState_Playing) {
+                stage->runTurn();
+                ++stream.turns;
+            }
+            stream.score = stage->score();
+        }
+        delete stage;
+        Solver::Select(*sRecordedSolver);
+    }
+
+    //------------------------------------------------------------------------------
+    /// 記録した出力を再生し、計測範囲の時間を返します。
+    ///
+    /// @param[in] aMode      計測する範囲。
+    /// @param[in] aStreams   ステージごとの出力。
+    /// @param[out] aScore    得点の合計。(記録したときと一致するはず)
+    ///
+    /// @return 計測範囲の時間[ナノ秒]。
+    int64_t Replay(BenchMode aMode, std::vector<StageStream>& aStreams, int64_t& aScore)
+    {
+        Solver::Select(ReplayEntry);
+        aScore = 0;
+        int64_t nanoSec = 0;
+        if (aMode == BenchMode_Game) {
+            // Game は全ステージの記録を持ち大きいので、ヒープに作る。
+            Random random = aStreams.front().random;
+            Game* game = new Game(random);
+            const int64_t begin = NowNanoSec();
+            while (game->isValidStage() && game->currentStageIndex() < static_cast<int>(aStreams.size())) {
+                sStream = &aStreams[game->currentStageIndex()];
+                game->startStage(true, 0.0);
+                while (game->state() == StageState_Playing) {
+                    game->runTurn();
+                }
+                game->onStageDone();
+            }
+            nanoSec = NowNanoSec() - begin;
+            aScore = game->record().score();
+            delete game;
+        }
+        else {
+            const bool writesRecord = aMode == BenchMode_RunTurnRecord;
+            Stage* stage = new Stage();
+            Record* record = writesRecord ? new Record() : 0;
+            for (size_t i = 0; i < aStreams.size(); ++i) {
+                // ステージの生成は計測しない。
+                Random random = aStreams[i].random;
+                LevelDesigner::Setup(static_cast<int>(i), *stage, random);
+                sStream = &aStreams[i];
+                const int64_t begin = NowNanoSec();
+                stage->start(true);
+                if (writesRecord) {
+                    record->writeStartStage(static_cast<int>(i), *stage);
+                    record->writeTurn(stage->lastTurnResult());
+                }
+                while (stage->lastTurnResult().state == StageState_Playing) {
+                    stage->runTurn();
+                    if (writesRecord) {
+                        record->writeTurn(stage->lastTurnResult());
+                    }
+                }
+                if (writesRecord) {
+                    record->writeEndStage(*stage);
+                }
+                nanoSec += NowNanoSec() - begin;
+                aScore += stage->score();
+            }
+            delete record;
+            delete stage;
+        }
+        Solver::Select(*sRecordedSolver);
+        return nanoSec;
+    }
+}
+
+//------------------------------------------------------------------------------
+/// ゲーム進行部分(Stage / Game / Record)のマイクロベンチマークのエントリポイントです。
+///
+/// 最初に選んだ解答でステージを解いて、時間帯ごとの積み込みと各ターンの動作を記録します。
+/// その後は記録をそのまま返すだけの解答に差し替えて繰り返し再生し、解答の時間を含まない
+/// ゲーム進行部分だけの時間を計測します。結果は JSON で標準出力に書きます。
+///
+///  - runTurn        : Stage::start と Stage::runTurn
+///  - runTurn+record : 上に加えて Record::writeStartStage / writeTurn / writeEndStage
+///  - game           : Game::startStage / runTurn / onStageDone (ステージの生成を含む)
+///
+///   オプション   | 説明
+///  --------------|----------------------------------------------
+///   -seed x,y,z,w | ステージを生成する乱数のシードを指定します。(省略時は Random の既定のシード)
+///   -n count     | 使うステージの数を指定します。(既定は全ステージ)
+///   -r count     | 繰り返し回数を指定します。(既定は 5)
+///   -solver name | 出力を記録する解答を選びます。(Solver::Select と同じく名前か .so のパス)
+///
+/// @return 正常に終了したら 0 、引数が不正か、再生した得点が記録と一致しなければ 1 を返します。
+int main(int argc, const char* argv[])
+{
+    Random random;
+    int stageCount = Parameter::GameStageCount;
+    int repeatCount = DefaultRepeatCount;
+    for (int i = 1; i < argc; ++i) {
+        if (!std::strcmp(argv[i], "-seed") && i + 1 < argc) {
+            uint values[Random::SeedCount];
+            if (!Random::ParseSeeds(argv[++i], values)) {
+                HPC_PRINT("Invalid Argument: %s is not a seed (x,y,z,w).\n", argv[i]);
+                return 1;
+            }
+            random = Random(values[0], values[1], values[2], values[3]);
+        }
+        else if (!std::strcmp(argv[i], "-n") && i + 1 < argc) {
+            stageCount = std::atoi(argv[++i]);
+            if (stageCount <= 0 || Parameter::GameStageCount < stageCount) {
+                HPC_PRINT("Invalid Argument: -n needs a count from 1 to %d.\n", Parameter::GameStageCount);
+                return 1;
+            }
+        }
+        else if (!std::strcmp(argv[i], "-r") && i + 1 < argc) {
+            repeatCount = std::atoi(argv[++i]);
+            if (repeatCount <= 0) {
+                HPC_PRINT("Invalid Argument: -r needs a positive count.\n");
+                return 1;
+            }
+        }
+        else if (!std::strcmp(argv[i], "-solver") && i + 1 < argc) {
+            if (!Solver::Select(argv[++i])) {
+                HPC_PRINT("Invalid Argument: %s is unknown solver.\n", argv[i]);
+                return 1;
+            }
+        }
+        else {
+            HPC_PRINT("Invalid Argument: %s is unknown command.\n", argv[i]);
+            return 1;
+        }
+    }
+
+    std::vector<StageStream> streams;
+    RecordStreams(random, stageCount, streams);
+    int64_t recordedScore = 0;
+    int64_t turns = 0;
+    for (size_t i = 0; i < streams.size(); ++i) {
+        recordedScore += streams[i].score;
+        turns += streams[i].turns;
+    }
+
+    HPC_PRINT("{\"solver\":\"%s\",\"stages\":%d,\"turns\":%lld,\"repeat\":%d,\"modes\":[",
+        Solver::Current().name, stageCount, static_cast<long long>(turns), repeatCount);
+    bool isScoreMatched = true;
+    for (int mode = 0; mode < BenchMode_TERM; ++mode) {
+        std::vector<int64_t> nanoSecs;
+        for (int r = 0; r < repeatCount; ++r) {
+            int64_t score = 0;
+            nanoSecs.push_back(Replay(static_cast<BenchMode>(mode), streams, score));
+            isScoreMatched = isScoreMatched && score == recordedScore;
+        }
+        std::sort(nanoSecs.begin(), nanoSecs.end());
+        int64_t sum = 0;
+        for (size_t r = 0; r < nanoSecs.size(); ++r) {
+            sum += nanoSecs[r];
+        }
+        const double minNanoSec = static_cast<double>(nanoSecs.front());
+        const double meanNanoSec = static_cast<double>(sum) / nanoSecs.size();
+        HPC_PRINT("%s\n{\"name\":\"%s\",\"ms\":{\"min\":%.3f,\"mean\":%.3f},\"nsPerTurn\":{\"min\":%.2f,\"mean\":%.2f},\"turnsPerSec\":{\"max\":%.0f,\"mean\":%.0f}}",
+            mode == 0 ? "" : ",", BenchModeNames[mode],
+            minNanoSec / 1e6, meanNanoSec / 1e6,
+            minNanoSec / turns, meanNanoSec / turns,
+            turns / minNanoSec * 1e9, turns / meanNanoSec * 1e9);
+    }
+    HPC_PRINT("],\n\"score\":%lld,\"replayMatched\":%s}\n", static_cast<long long>(recordedScore), isScoreMatched ? "true" : "false");
+    return isScoreMatched ? 0 : 1;
+}
+
+//------------------------------------------------------------------------------
+// EOF
@@ -0,0 +1,279 @@
+//------------------------------------------------------------------------------
+/// @file
+/// @brief    経路探索のベンチマーク用の main 関数
+/// @author   ハル研究所プログラミングコンテスト実行委員会
+///
+/// @copyright  Copyright (c) 2015 HAL Laboratory, Inc.
+/// @attention  このファイルの利用は、同梱のREADMEにある
+///             利用条件に従ってください
+
+//------------------------------------------------------------------------------
+
+// 解答の探索は Answer.cpp の中に閉じているので、このファイルに取り込んで直接呼び出す。
+// (Answer.cpp は HPC_PATH_BENCH のときだけ、経路表を使う前の A*/BFS/JPS の探索を残して Path を PathBench に公開し、
+//  展開したノードを数える。解答そのものは経路表しか使わない)
+#define HPC_PATH_BENCH
+#include "Answer.cpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include "HPCCommon.hpp"
+#include "HPCField.hpp"
+
+//------------------------------------------------------------------------------
+namespace {
+    /// 動的確保の回数。このプログラムはスレッドを使わないので、そのまま数える。
+    long long sAllocCount = 0;
+}
+
+//------------------------------------------------------------------------------
+/// 動的確保を数えるために置き換えます。
+void* operator new(std::size_t aSize)
+{
+    ++sAllocCount;
+    void* pointer = std::malloc(aSize == 0 ? 1 : aSize);
+    if (pointer == 0) {
+        throw std::bad_alloc();
+    }
+    return pointer;
+}
+
+//------------------------------------------------------------------------------
+void operator delete(void* aPointer) noexcept
+{
+    std::free(aPointer);
+}
+
+namespace hpc {
+
+    //------------------------------------------------------------------------------
+    /// 計測する経路探索の方式を表します。
+    enum PathKernel {
+        PathKernel_AStar,           ///< Path::a_star
+        PathKernel_Bfs,             ///< Path::bfs
+        PathKernel_Jps,             ///< Path::jump_point_search
+        PathKernel_TableBuild,      ///< PathDatabase の目的地の行を 1 つ作る (距離と最初の一手の表)
+        PathKernel_TableRoute,      ///< 作っておいた PathDatabase の最初の一手を辿る
+        PathKernel_TableDistance,   ///< 作っておいた PathDatabase の距離を引く
+        PathKernel_TERM
+    };
+
+    //------------------------------------------------------------------------------
+    /// Answer.cpp の経路探索を直接呼び出します。
+    class PathBench
+    {
+    public:
+        static const char* Name(PathKernel aKernel);
+
+        //------------------------------------------------------------------------------
+        /// aStart から aGoal までの経路の長さを求めます。
+        ///
+        /// @param[in] aDatabase PathKernel_TableRoute と PathKernel_TableDistance で使う、目的地の行を作っておいた表。
+        static int Query(PathKernel aKernel, const Field& aField, PathDatabase& aDatabase, const Pos& aStart, const Pos& aGoal)
+        {
+            const Path path;
+            switch (aKernel) {
+            case PathKernel_AStar:
+                return static_cast<int>(path.a_star(aField, aStart, aGoal).size());
+            case PathKernel_Bfs:
+                return static_cast<int>(path.bfs(aField, aStart, aGoal).size());
+            case PathKernel_Jps:
+                return static_cast<int>(path.jump_point_search(aField, aStart, aGoal).size());
+            case PathKernel_TableBuild:
+                {
+                    PathDatabase database;
+                    database.reset(aField);
+                    database.prepare(aGoal);
+                    return database.distance(aStart, aGoal);
+                }
+            case PathKernel_TableRoute:
+                return static_cast<int>(aDatabase.route(aStart, aGoal).size());
+            case PathKernel_TableDistance:
+                return aDatabase.distance(aStart, aGoal);
+            default:
+                HPC_SHOULD_NOT_REACH_HERE();
+                return 0;
+            }
+        }
+    };
+
+    //------------------------------------------------------------------------------
+    /// @return 方式の名前。
+    const char* PathBench::Name(PathKernel aKernel)
+    {
+        static const char* const Names[PathKernel_TERM] = {
+            "a_star",
+            "bfs",
+            "jps",
+            "table_build",
+            "table_route",
+            "table_distance",
+        };
+        HPC_RANGE_ASSERT_MIN_UB_I(aKernel, 0, PathKernel_TERM);
+        return Names[aKernel];
+    }
+}
+
+//------------------------------------------------------------------------------
+namespace {
+    using namespace hpc;
+
+    const int DefaultFieldCount = 4;        ///< フィールドの種類ごとのフィールド数の既定値
+    const int DefaultQueryCount = 64;       ///< フィールドごとの問い合わせ数の既定値
+    const int DefaultRepeatCount = 3;       ///< 繰り返し回数の既定値
+
+    /// 1 つの問い合わせ
+    struct Query {
+        int field;  ///< フィールドの番号
+        Pos start;  ///< 出発点
+        Pos goal;   ///< 目的地
+    };
+
+    //------------------------------------------------------------------------------
+    /// @return 計測に使う現在時刻[ナノ秒]。
+    int64_t NowNanoSec()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    //------------------------------------------------------------------------------
+    /// @return フィールドの中の、壁でないマスを無作為に 1 つ。
+    Pos RandomOpenPos(const Field& aField, Random& aRandom)
+    {
+        while (true) {
+            const Pos pos(aRandom.randTerm(aField.width()), aRandom.randTerm(aField.height()));
+            if (!aField.isWall(pos)) {
+                return pos;
+            }
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+/// 経路探索のベンチマークのエントリポイントです。
+///
+/// 壁密度の段階(LevelDesigner と同じ 20, 40, ..., 100)とフィールドの大きさ(19, 23, 27, 31 の正方形)の
+/// 組ごとに Field::setup でフィールドを作り、無作為な 2 点間の問い合わせを各方式で解きます。
+/// 方式ごとに、問い合わせ 1 回あたりの時間・展開したノード数・動的確保の回数を、
+/// 1 行 1 つの JSON (NDJSON) で標準出力に書きます。時間は繰り返しの最小値です。
+///
+/// 各行の lengthMismatch は、経路の長さが BFS (最短)と一致しなかった問い合わせの数です。
+/// Path::a_star は一度開いたノードのコストを更新しないので、最短にならないことがあります。
+/// (解答が実際に使うのは PathDatabase の表です)
+///
+///   オプション   | 説明
+///  --------------|----------------------------------------------
+///   -seed x,y,z,w | フィールドと問い合わせを作る乱数のシードを指定します。(省略時は Random の既定のシード)
+///   -f count     | 組ごとのフィールド数を指定します。(既定は 4)
+///   -q count     | フィールドごとの問い合わせ数を指定します。(既定は 64)
+///   -r count     | 繰り返し回数を指定します。(既定は 3)
+///
+/// @return 正常に終了したら 0 、引数が不正なら 1 を返します。
+int main(int argc, const char* argv[])
+{
+    Random random;
+    int fieldCount = DefaultFieldCount;
+    int queryCount = DefaultQueryCount;
+    int repeatCount = DefaultRepeatCount;
+    for (int i = 1; i < argc; ++i) {
+        if (!std::strcmp(argv[i], "-seed") && i + 1 < argc) {
+            uint values[Random::SeedCount];
+            if (!Random::ParseSeeds(argv[++i], values)) {
+                HPC_PRINT("Invalid Argument: %s is not a seed (x,y,z,w).\n", argv[i]);
+                return 1;
+            }
+            random = Random(values[0], values[1], values[2], values[3]);
+        }
+        else if ((!std::strcmp(argv[i], "-f") || !std::strcmp(argv[i], "-q") || !std::strcmp(argv[i], "-r")) && i + 1 < argc) {
+            const int value = std::atoi(argv[i + 1]);
+            if (value <= 0) {
+                HPC_PRINT("Invalid Argument: %s needs a positive count.\n", argv[i]);
+                return 1;
+            }
+            (argv[i][1] == 'f' ? fieldCount : argv[i][1] == 'q' ? queryCount : repeatCount) = value;
+            ++i;
+        }
+        else {
+            HPC_PRINT("Invalid Argument: %s is unknown command.\n", argv[i]);
+            return 1;
+        }
+    }
+
+    std::vector<Field> fields(fieldCount);
+    std::vector<Query> queries;
+    for (int densityIndex = 0; densityIndex < Parameter::WallDensityMax; ++densityIndex) {
+        const int wallDensity = (densityIndex + 1) * (100 / Parameter::WallDensityMax);
+        for (int size = Parameter::FieldWidthMin; size <= Parameter::FieldWidthMax; size += 4) {
+            queries.clear();
+            for (int f = 0; f < fieldCount; ++f) {
+                fields[f].setup(size, size, wallDensity, random);
+                for (int q = 0; q < queryCount; ++q) {
+                    const Query query = { f, RandomOpenPos(fields[f], random), RandomOpenPos(fields[f], random) };
+                    queries.push_back(query);
+                }
+            }
+
+            // 基準の長さは BFS で求める。
+            std::vector<int> lengths(queries.size());
+            std::vector<PathDatabase> databases(fieldCount);
+            for (int f = 0; f < fieldCount; ++f) {
+                init_search(fields[f]);
+                databases[f].reset(fields[f]);
+            }
+            for (size_t q = 0; q < queries.size(); ++q) {
+                init_search(fields[queries[q].field]);
+                lengths[q] = PathBench::Query(PathKernel_Bfs, fields[queries[q].field], databases[queries[q].field], queries[q].start, queries[q].goal);
+            }
+
+            for (int kernel = 0; kernel < PathKernel_TERM; ++kernel) {
+                int64_t minNanoSec = 0;
+                long long expanded = 0;
+                long long allocs = 0;
+                int mismatchCount = 0;
+                for (int r = 0; r < repeatCount; ++r) {
+                    int64_t nanoSec = 0;
+                    search_expanded_count = 0;
+                    const long long allocBegin = sAllocCount;
+                    // 問い合わせはフィールドごとにまとめて流す。フィールドの切り替え(init_search)と表の準備は計測しない。
+                    for (int f = 0; f < fieldCount; ++f) {
+                        init_search(fields[f]);
+                        if (kernel == PathKernel_TableRoute || kernel == PathKernel_TableDistance) {
+                            const long long expandedBegin = search_expanded_count;
+                            const long long preparedAllocBegin = sAllocCount;
+                            for (int q = 0; q < queryCount; ++q) {
+                                databases[f].prepare(queries[f * queryCount + q].goal);
+                            }
+                            search_expanded_count = expandedBegin;
+                            sAllocCount = preparedAllocBegin;
+                        }
+                        const int64_t begin = NowNanoSec();
+                        for (int q = f * queryCount; q < (f + 1) * queryCount; ++q) {
+                            const int length = PathBench::Query(static_cast<PathKernel>(kernel), fields[f], databases[f], queries[q].start, queries[q].goal);
+                            if (r == 0 && length != lengths[q]) {
+                                ++mismatchCount;
+                            }
+                        }
+                        nanoSec += NowNanoSec() - begin;
+                    }
+                    if (r == 0 || nanoSec < minNanoSec) {
+                        minNanoSec = nanoSec;
+                    }
+                    expanded = search_expanded_count;
+                    allocs = sAllocCount - allocBegin;
+                }
+                const double count = static_cast<double>(queries.size());
+                HPC_PRINT("{\"kernel\":\"%s\",\"wallDensity\":%d,\"width\":%d,\"height\":%d,\"queries\":%d,"
+                    "\"nsPerQuery\":%.1f,\"expandedPerQuery\":%.2f,\"allocsPerQuery\":%.2f,\"lengthMismatch\":%d}\n",
+                    PathBench::Name(static_cast<PathKernel>(kernel)), wallDensity, size, size, static_cast<int>(queries.size()),
+                    minNanoSec / count, expanded / count, allocs / count, mismatchCount);
+            }
+        }
+    }
+    return 0;
+}
+
+//------------------------------------------------------------------------------
+// EOF
@@ -0,0 +1,498 @@
+//------------------------------------------------------------------------------
+/// @file
+/// @brief    荷物数を増やしたときの計画の解き方の伸び方を測るベンチマーク用の main 関数
+/// @author   ハル研究所プログラミングコンテスト実行委員会
+///
+/// @copyright  Copyright (c) 2015 HAL Laboratory, Inc.
+/// @attention  このファイルの利用は、同梱のREADMEにある
+///             利用条件に従ってください
+
+//------------------------------------------------------------------------------
+
+// 解答の計画の戦略は Answer.cpp の中に閉じているので、このファイルに取り込んで直接呼び出す。
+#include "Answer.cpp"
+
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include "HPCCommon.hpp"
+
+//------------------------------------------------------------------------------
+namespace {
+    using namespace hpc;
+
+    const int DefaultItemCounts[] = { 8, 16, 32, 64, 128, 256 };   ///< 荷物数の既定値
+    const int DefaultInstanceCount = 3;                 ///< 荷物数ごとの問題数の既定値
+    const int DefaultWallDensityIndex = 2;              ///< 壁密度の段階の既定値 (LevelDesigner と同じ 0 から)
+    const int DefaultPeriodSpecifiedIndex = 2;          ///< 時間帯指定の割合の段階の既定値 (LevelDesigner と同じ 0 から)
+    const int ChartWidth = 40;                          ///< 表示するグラフの幅[文字]
+
+    /// 計測する戦略
+    enum ScaleStrategy {
+        ScaleStrategy_Greedy,       ///< choose_item
+        ScaleStrategy_Regret,       ///< regret_insertion (k を変えて一番良いもの)
+        ScaleStrategy_MultiStart,   ///< multi_start (choose_item の計画から)
+        ScaleStrategy_Exact,        ///< ExactPlanner (choose_item の計画から。ExactItemMax 個まで)
+        ScaleStrategy_Lns,          ///< large_neighborhood_search (choose_item の計画から)
+        ScaleStrategy_Portfolio,    ///< run_portfolio (解答が実際に使うもの)
+        ScaleStrategy_TERM
+    };
+
+    /// 戦略の名前
+    const char* const StrategyNames[ScaleStrategy_TERM] = {
+        "greedy",
+        "regret",
+        "multi",
+        "exact",
+        "lns",
+        "portfolio",
+    };
+
+    /// 荷物数と戦略ごとの集計
+    struct ScaleResult {
+        int runCount;           ///< 解いた問題数
+        int feasibleCount;      ///< 制約を満たす計画が得られた問題数
+        int infeasibleCount;    ///< 制限時間内に終わったのに、制約を満たす計画が得られなかった問題数
+        int timedOutCount;      ///< 制限時間に達した問題数
+        double solveMs;         ///< 時間の合計[ミリ秒]
+        double maxSolveMs;      ///< 時間の最大値[ミリ秒]
+        double fuel;            ///< 制約を満たしたときの燃料の合計
+        double fuelRatio;       ///< 制約を満たしたときの、その問題で一番良い戦略の燃料との比の合計
+    };
+
+    //------------------------------------------------------------------------------
+    /// @return 荷物数 aItemCount に合わせたフィールドの幅と高さ。
+    ///         荷物 16 個で最大の 31 になるように、面積を荷物数に比例させる。(4 で割って 3 余る数に切り上げ)
+    int FieldSize(int aItemCount)
+    {
+        const double size = Parameter::FieldWidthMax * std::sqrt(static_cast<double>(aItemCount) / Parameter::ItemCountMax);
+        const int step = static_cast<int>(std::ceil((size - 3.0) / 4.0));
+        return Math::Max(Parameter::FieldWidthMin, step * 4 + 3);
+    }
+
+    //------------------------------------------------------------------------------
+    /// @return 荷物数 aItemCount に合わせた時間帯の数。荷物 16 個で 4 つになるように比例させる。
+    int PeriodCount(int aItemCount)
+    {
+        return Math::Max(Parameter::PeriodCount, (aItemCount * Parameter::PeriodCount + Parameter::ItemCountMax - 1) / Parameter::ItemCountMax);
+    }
+
+    //------------------------------------------------------------------------------
+    /// Field::setup と同じ方法で、大きさの上限のない迷路を作ります。
+    ///
+    /// @param[out] aWalls 壁かどうか(y * aSize + x)。
+    void SetupWalls(int aSize, int aDensity, Random& aRandom, std::vector<bool>& aWalls)
+    {
+        aWalls.assign(aSize * aSize, true);
+        const int center = (aSize - 1) / 2;
+        aWalls[center * aSize + center] = false;
+
+        // すでに通路になっているところから、通路になるべきなのにまだなってないところに向かって掘る
+        const int grid = (aSize - 1) / 2;
+        int count = grid * grid - 1;
+        while (count > 0) {
+            const Pos pos(aRandom.randTerm(grid) * 2 + 1, aRandom.randTerm(grid) * 2 + 1);
+            if (aWalls[pos.y * aSize + pos.x]) {
+                continue;
+            }
+            const Action dir = static_cast<Action>(aRandom.randTerm(4));
+            const Pos middle = pos.move(dir);
+            const Pos next = middle.move(dir);
+            if (0 <= next.x && next.x < aSize && 0 <= next.y && next.y < aSize && aWalls[next.y * aSize + next.x]) {
+                aWalls[next.y * aSize + next.x] = false;
+                aWalls[middle.y * aSize + middle.x] = false;
+                --count;
+            }
+        }
+
+        // 壁密度に合わせて適当に掘る
+        for (int y = 1; y < aSize - 1; ++y) {
+            for (int x = 1; x < aSize - 1; ++x) {
+                if ((x + y) % 2 == 1 && aRandom.randTerm(100) >= aDensity) {
+                    aWalls[y * aSize + x] = false;
+                }
+            }
+        }
+    }
+
+    //------------------------------------------------------------------------------
+    /// LevelDesigner::Setup と同じ方法で、荷物数 aItemCount の計画問題を作ります。
+    ///
+    /// 荷物の重さの偏りと時間帯指定の決め方は LevelDesigner と同じで、
+    /// フィールドの大きさと時間帯の数を荷物数に合わせて大きくします。距離は迷路の上の最短距離です。
+    void SetupProblem(int aItemCount, int aWallDensityIndex, int aPeriodSpecifiedIndex, Random& aRandom, PlanProblem& aProblem)
+    {
+        const int size = FieldSize(aItemCount);
+        const int cellCount = size * size;
+        std::vector<bool> walls;
+        SetupWalls(size, (aWallDensityIndex + 1) * (100 / Parameter::WallDensityMax), aRandom, walls);
+
+        aProblem.item_count = aItemCount;
+        aProblem.office = aItemCount;
+        aProblem.truck_weight = Parameter::TruckWeight;
+        aProblem.capacity = Parameter::TruckWeightCapacity;
+        aProblem.period_count = PeriodCount(aItemCount);
+        aProblem.weight.assign(aItemCount, 0);
+        aProblem.period.assign(aItemCount, -1);
+
+        // 重さ。同じ重さの荷物が偏りすぎないようにする。
+        const int weightKindCount = Parameter::ItemWeightMax - Parameter::ItemWeightMin + 1;
+        const int weightHistogramMax = (aItemCount + weightKindCount - 1) / weightKindCount;
+        std::vector<int> weightHistogram(Parameter::ItemWeightMax + 1, 0);
+        for (int i = 0; i < aItemCount; ++i) {
+            int weight;
+            do {
+                weight = aRandom.randMinMax(Parameter::ItemWeightMin, Parameter::ItemWeightMax);
+            } while (weightHistogram[weight] >= weightHistogramMax);
+            aProblem.weight[i] = weight;
+            ++weightHistogram[weight];
+        }
+
+        // 時間帯指定。指定だけで積みきれなくならないようにする。
+        const int periodSpecifiedCount = aItemCount * aPeriodSpecifiedIndex / (Parameter::PeriodSpecifiedMax - 1);
+        std::vector<int> periodWeightSum(aProblem.period_count, 0);
+        for (int i = 0; i < periodSpecifiedCount; ++i) {
+            while (true) {
+                const int item = aRandom.randTerm(aItemCount);
+                const int period = aRandom.randTerm(aProblem.period_count);
+                if (aProblem.period[item] == -1 && periodWeightSum[period] + aProblem.weight[item] <= Parameter::TruckWeightCapacity) {
+                    aProblem.period[item] = period;
+                    periodWeightSum[period] += aProblem.weight[item];
+                    break;
+                }
+            }
+        }
+
+        // 配達先。壁でも営業所でもなく、重ならないマス。最後が営業所。
+        std::vector<int> cells(aItemCount + 1);
+        std::vector<bool> isUsed(cellCount, false);
+        cells[aItemCount] = (size - 1) / 2 * size + (size - 1) / 2;
+        isUsed[cells[aItemCount]] = true;
+        for (int i = 0; i < aItemCount; ++i) {
+            int cell;
+            do {
+                cell = aRandom.randTerm(size) * size + aRandom.randTerm(size);
+            } while (walls[cell] || isUsed[cell]);
+            cells[i] = cell;
+            isUsed[cell] = true;
+        }
+
+        // 各点からの幅優先探索で距離の表を作る。
+        const int pointCount = aItemCount + 1;
+        aProblem.dist.assign(pointCount * pointCount, 0);
+        std::vector<int> distances(cellCount);
+        std::vector<int> queue(cellCount);
+        const int offsets[4] = { -1, 1, -size, size };
+        for (int from = 0; from < pointCount; ++from) {
+            std::fill(distances.begin(), distances.end(), -1);
+            int head = 0;
+            int tail = 0;
+            distances[cells[from]] = 0;
+            queue[tail++] = cells[from];
+            while (head < tail) {
+                const int here = queue[head++];
+                for (int i = 0; i < 4; ++i) {
+                    const int next = here + offsets[i];
+                    if (!walls[next] && distances[next] < 0) {
+                        distances[next] = distances[here] + 1;
+                        queue[tail++] = next;
+                    }
+                }
+            }
+            for (int to = 0; to < pointCount; ++to) {
+                aProblem.dist[from * pointCount + to] = distances[cells[to]];
+            }
+        }
+    }
+
+    //------------------------------------------------------------------------------
+    /// @return 計画が、全ての荷物をちょうど 1 回運び、積載量と時間帯指定を守っていれば @c true 。
+    bool IsFeasible(const PlanProblem& aProblem, const Plan& aPlan)
+    {
+        if (static_cast<int>(aPlan.size()) != aProblem.period_count) {
+            return false;
+        }
+        std::vector<int> counts(aProblem.item_count, 0);
+        for (int t = 0; t < aProblem.period_count; ++t) {
+            int load = 0;
+            for (size_t k = 0; k < aPlan[t].size(); ++k) {
+                const int item = aPlan[t][k];
+                if (item < 0 || aProblem.item_count <= item || (aProblem.period[item] != -1 && aProblem.period[item] != t)) {
+                    return false;
+                }
+                ++counts[item];
+                load += aProblem.weight[item];
+            }
+            if (load > aProblem.capacity) {
+                return false;
+            }
+        }
+        return std::count(counts.begin(), counts.end(), 1) == aProblem.item_count;
+    }
+
+    //------------------------------------------------------------------------------
+    /// 1 つの戦略で計画を作ります。
+    ///
+    /// multi, exact, lns は choose_item の計画から始めます。その計画を作る時間は含めません。
+    ///
+    /// @param[in] aLimitSec 制限時間[秒]。制限時間を見ない戦略(greedy, multi)には関係ありません。
+    /// @param[out] aPlan    作った計画。
+    /// @param[out] aIsTimedOut 制限時間に達したか。制限時間を見ない戦略は常に @c false 。
+    ///
+    /// @return 時間[秒]。戦略が使えない問題なら負の値。
+    double Solve(ScaleStrategy aStrategy, const PlanProblem& aProblem, double aLimitSec, Plan& aPlan, bool& aIsTimedOut)
+    {
+        if (aStrategy == ScaleStrategy_Exact && (aProblem.item_count > ExactItemMax || aProblem.period_count > Parameter::PeriodCount)) {
+            return -1.0;
+        }
+        aPlan.clear();
+        if (aStrategy == ScaleStrategy_MultiStart || aStrategy == ScaleStrategy_Exact || aStrategy == ScaleStrategy_Lns) {
+            choose_item(aProblem, aPlan);
+        }
+
+        Timer timer(aLimitSec, TimerMode_Wall);
+        Timer wallTimer(0, TimerMode_Wall);
+        timer.start();
+        wallTimer.start();
+        switch (aStrategy) {
+        case ScaleStrategy_Greedy:
+            choose_item(aProblem, aPlan);
+            break;
+        case ScaleStrategy_Regret:
+            {
+                Plan plan;
+                for (int k = RegretKMin; k <= aProblem.period_count && timer.isInTime(); ++k) {
+                    if (regret_insertion(aProblem, timer, k, plan) && (aPlan.empty() || get_plan_cost(aProblem, plan) < get_plan_cost(aProblem, aPlan))) {
+                        aPlan.swap(plan);
+                    }
+                }
+            }
+            break;
+        case ScaleStrategy_MultiStart:
+            multi_start(aProblem, MultiStartCount, aPlan);
+            break;
+        case ScaleStrategy_Exact:
+            ExactPlanner(aProblem, timer, ExactNodeMax).solve(aPlan);
+            break;
+        case ScaleStrategy_Lns:
+            {
+                Random random;
+                large_neighborhood_search(aProblem, timer, LnsIterationMax, random, aPlan);
+            }
+            break;
+        case ScaleStrategy_Portfolio:
+            run_portfolio(aProblem, timer, aPlan);
+            break;
+        default:
+            HPC_SHOULD_NOT_REACH_HERE();
+            break;
+        }
+        const double sec = wallTimer.pastSec();
+        aIsTimedOut = aStrategy != ScaleStrategy_Greedy && aStrategy != ScaleStrategy_MultiStart && !timer.isInTime();
+        return sec;
+    }
+
+    //------------------------------------------------------------------------------
+    /// "8,16,32" のような整数の並びを読みます。
+    ///
+    /// @return 正の整数の並びとして読めたら @c true 。
+    bool ParseCounts(const char* aText, std::vector<int>& aCounts)
+    {
+        aCounts.clear();
+        const char* text = aText;
+        while (*text != '\0') {
+            char* end = 0;
+            const long value = std::strtol(text, &end, 10);
+            if (end == text || value <= 0 || (*end != ',' && *end != '\0')) {
+                return false;
+            }
+            aCounts.push_back(static_cast<int>(value));
+            text = *end == ',' ? end + 1 : end;
+        }
+        return !aCounts.empty();
+    }
+}
+
+//------------------------------------------------------------------------------
+/// 荷物数を増やしたときの計画の解き方の伸び方を測るベンチマークのエントリポイントです。
+///
+/// 本番のステージは荷物 16 個・フィールド 31 マスまでで、Stage や ItemGroup もその大きさに固定されています。
+/// そこで、このベンチマークはステージを使わず、LevelDesigner と同じ方法で作った大きな迷路と荷物から
+/// 解答の計画問題(PlanProblem)を直接作り、解答の戦略ごとに解く時間と燃料を測ります。
+/// フィールドの面積と時間帯の数は、荷物 16 個のときに本番と同じになるよう荷物数に比例させます。
+///
+/// 荷物数と戦略ごとの平均を CSV で書き、最後に解く時間と fuelRatio (どちらも対数目盛)のグラフを表示します。
+/// fuelRatio はその問題で一番燃料の少ない戦略との比で、feasible は制限時間内に終わった問題のうち
+/// 制約を満たす計画が得られた割合です。制限時間に達して計画が得られなかった問題は timedOut にだけ表れます。
+///
+///   オプション   | 説明
+///  --------------|----------------------------------------------
+///   -n a,b,...   | 荷物数の並びを指定します。(既定は 8,16,32,64,128,256)
+///   -i count     | 荷物数ごとの問題数を指定します。(既定は 3)
+///   -l msec      | 制限時間を見る戦略の制限時間を指定します。(既定は解答の既定と同じ 30 ミリ秒)
+///   -w index     | 壁密度の段階を指定します。(0 から 4 。既定は 2)
+///   -p index     | 時間帯指定の割合の段階を指定します。(0 から 5 。既定は 2)
+///   -seed x,y,z,w | 問題を作る乱数のシードを指定します。(省略時は Random の既定のシード)
+///
+/// @return 正常に終了したら 0 、引数が不正なら 1 を返します。
+int main(int argc, const char* argv[])
+{
+    std::vector<int> itemCounts(DefaultItemCounts, DefaultItemCounts + sizeof(DefaultItemCounts) / sizeof(DefaultItemCounts[0]));
+    int instanceCount = DefaultInstanceCount;
+    double limitSec = PortfolioTimeLimitSec;
+    int wallDensityIndex = DefaultWallDensityIndex;
+    int periodSpecifiedIndex = DefaultPeriodSpecifiedIndex;
+    Random random;
+    for (int i = 1; i < argc; ++i) {
+        if (!std::strcmp(argv[i], "-n") && i + 1 < argc) {
+            if (!ParseCounts(argv[++i], itemCounts)) {
+                HPC_PRINT("Invalid Argument: %s is not a list of item counts.\n", argv[i]);
+                return 1;
+            }
+        }
+        else if (!std::strcmp(argv[i], "-i") && i + 1 < argc) {
+            instanceCount = std::atoi(argv[++i]);
+            if (instanceCount <= 0) {
+                HPC_PRINT("Invalid Argument: -i needs a positive count.\n");
+                return 1;
+            }
+        }
+        else if (!std::strcmp(argv[i], "-l") && i + 1 < argc) {
+            limitSec = std::atof(argv[++i]) / 1000.0;
+            if (limitSec <= 0.0) {
+                HPC_PRINT("Invalid Argument: -l needs a positive time in milliseconds.\n");
+                return 1;
+            }
+        }
+        else if (!std::strcmp(argv[i], "-w") && i + 1 < argc) {
+            wallDensityIndex = std::atoi(argv[++i]);
+            if (wallDensityIndex < 0 || Parameter::WallDensityMax <= wallDensityIndex) {
+                HPC_PRINT("Invalid Argument: -w needs an index from 0 to %d.\n", Parameter::WallDensityMax - 1);
+                return 1;
+            }
+        }
+        else if (!std::strcmp(argv[i], "-p") && i + 1 < argc) {
+            periodSpecifiedIndex = std::atoi(argv[++i]);
+            if (periodSpecifiedIndex < 0 || Parameter::PeriodSpecifiedMax <= periodSpecifiedIndex) {
+                HPC_PRINT("Invalid Argument: -p needs an index from 0 to %d.\n", Parameter::PeriodSpecifiedMax - 1);
+                return 1;
+            }
+        }
+        else if (!std::strcmp(argv[i], "-seed") && i + 1 < argc) {
+            uint values[Random::SeedCount];
+            if (!Random::ParseSeeds(argv[++i], values)) {
+                HPC_PRINT("Invalid Argument: %s is not a seed (x,y,z,w).\n", argv[i]);
+                return 1;
+            }
+            random = Random(values[0], values[1], values[2], values[3]);
+        }
+        else {
+            HPC_PRINT("Invalid Argument: %s is unknown command.\n", argv[i]);
+            return 1;
+        }
+    }
+
+    const ScaleResult emptyResult = { 0, 0, 0, 0, 0.0, 0.0, 0.0, 0.0 };
+    std::vector<std::vector<ScaleResult> > results(itemCounts.size(), std::vector<ScaleResult>(ScaleStrategy_TERM, emptyResult));
+    HPC_PRINT("items,strategy,size,periods,instances,solveMs,maxSolveMs,timedOut,feasible,fuel,fuelRatio\n");
+    for (size_t c = 0; c < itemCounts.size(); ++c) {
+        for (int instance = 0; instance < instanceCount; ++instance) {
+            PlanProblem problem;
+            SetupProblem(itemCounts[c], wallDensityIndex, periodSpecifiedIndex, random, problem);
+
+            int fuels[ScaleStrategy_TERM];
+            int bestFuel = -1;
+            for (int strategy = 0; strategy < ScaleStrategy_TERM; ++strategy) {
+                Plan plan;
+                bool isTimedOut = false;
+                const double sec = Solve(static_cast<ScaleStrategy>(strategy), problem, limitSec, plan, isTimedOut);
+                fuels[strategy] = -1;
+                if (sec < 0.0) {
+                    continue;
+                }
+                ScaleResult& result = results[c][strategy];
+                ++result.runCount;
+                result.timedOutCount += isTimedOut ? 1 : 0;
+                result.solveMs += sec * 1000.0;
+                result.maxSolveMs = std::max(result.maxSolveMs, sec * 1000.0);
+                if (IsFeasible(problem, plan)) {
+                    ++result.feasibleCount;
+                    fuels[strategy] = get_plan_cost(problem, plan);
+                    result.fuel += fuels[strategy];
+                    bestFuel = bestFuel < 0 ? fuels[strategy] : Math::Min(bestFuel, fuels[strategy]);
+                }
+                else if (!isTimedOut) {
+                    ++result.infeasibleCount;
+                }
+            }
+            for (int strategy = 0; strategy < ScaleStrategy_TERM; ++strategy) {
+                if (fuels[strategy] >= 0) {
+                    results[c][strategy].fuelRatio += static_cast<double>(fuels[strategy]) / bestFuel;
+                }
+            }
+        }
+
+        for (int strategy = 0; strategy < ScaleStrategy_TERM; ++strategy) {
+            const ScaleResult& result = results[c][strategy];
+            if (result.runCount == 0) {
+                HPC_PRINT("%d,%s,%d,%d,0,,,,,,\n", itemCounts[c], StrategyNames[strategy], FieldSize(itemCounts[c]), PeriodCount(itemCounts[c]));
+                continue;
+            }
+            HPC_PRINT("%d,%s,%d,%d,%d,%.3f,%.3f,%.2f,", itemCounts[c], StrategyNames[strategy],
+                FieldSize(itemCounts[c]), PeriodCount(itemCounts[c]), result.runCount,
+                result.solveMs / result.runCount, result.maxSolveMs,
+                static_cast<double>(result.timedOutCount) / result.runCount);
+            // 制限時間に達して計画が得られなかった問題は、制約を満たせなかったとは数えない。
+            const int finishedCount = result.feasibleCount + result.infeasibleCount;
+            if (finishedCount > 0) {
+                HPC_PRINT("%.2f", static_cast<double>(result.feasibleCount) / finishedCount);
+            }
+            HPC_PRINT(",");
+            // 制約を満たす計画が 1 つもなければ、燃料は使えない戦略と同じく空欄にする。
+            if (result.feasibleCount == 0) {
+                HPC_PRINT(",\n");
+                continue;
+            }
+            HPC_PRINT("%.1f,%.4f\n", result.fuel / result.feasibleCount, result.fuelRatio / result.feasibleCount);
+        }
+    }
+
+    // 解く時間のグラフ。1 マイクロ秒から 10 秒までを対数目盛で表示する。
+    HPC_PRINT("\nSolve time [ms] (log scale, 1us .. 10s; * : timed out on some instances, - : not applicable)\n");
+    for (int strategy = 0; strategy < ScaleStrategy_TERM; ++strategy) {
+        HPC_PRINT("%s\n", StrategyNames[strategy]);
+        for (size_t c = 0; c < itemCounts.size(); ++c) {
+            const ScaleResult& result = results[c][strategy];
+            if (result.runCount == 0) {
+                HPC_PRINT("  %4d | -\n", itemCounts[c]);
+                continue;
+            }
+            const double ms = result.solveMs / result.runCount;
+            const double position = (std::log10(std::max(ms, 1e-3)) + 3.0) / 7.0;
+            const int length = Math::LimitMinMax(static_cast<int>(position * ChartWidth + 0.5), 1, ChartWidth);
+            HPC_PRINT("  %4d | %s %.3f%s\n", itemCounts[c], std::string(length, '#').c_str(), ms, result.timedOutCount > 0 ? " *" : "");
+        }
+    }
+
+    // fuelRatio のグラフ。比はほとんど 1 に近いので、一番良い戦略からの超過分 (fuelRatio - 1) を
+    // 0.01% から 100% までの対数目盛で表示する。
+    HPC_PRINT("\nFuel ratio to the best strategy (log scale of the excess, 0.01%% .. 100%%; - : no feasible plan or not applicable)\n");
+    for (int strategy = 0; strategy < ScaleStrategy_TERM; ++strategy) {
+        HPC_PRINT("%s\n", StrategyNames[strategy]);
+        for (size_t c = 0; c < itemCounts.size(); ++c) {
+            const ScaleResult& result = results[c][strategy];
+            if (result.feasibleCount == 0) {
+                HPC_PRINT("  %4d | -\n", itemCounts[c]);
+                continue;
+            }
+            const double ratio = result.fuelRatio / result.feasibleCount;
+            const double position = (std::log10(std::max(ratio - 1.0, 1e-4)) + 4.0) / 4.0;
+            const int length = Math::LimitMinMax(static_cast<int>(position * ChartWidth + 0.5), 1, ChartWidth);
+            HPC_PRINT("  %4d | %s %.4f\n", itemCounts[c], std::string(length, '#').c_str(), ratio);
+        }
+    }
+    return 0;
+}
+
+//------------------------------------------------------------------------------
+// EOF
@@ -0,0 +1,40 @@
+//------------------------------------------------------------------------------
+/// @file
+/// @brief    解答を共有ライブラリとして公開する入口
+/// @author   ハル研究所プログラミングコンテスト実行委員会
+///
+/// @copyright  Copyright (c) 2015 HAL Laboratory, Inc.
+/// @attention  このファイルの利用は、同梱のREADMEにある
+///             利用条件に従ってください
+
+//------------------------------------------------------------------------------
+
+#include "HPCAnswer.hpp"
+#include "HPCSolver.hpp"
+
+/// 解答の名前。make plugins では元のファイル名が指定されます。
+#ifndef HPC_SOLVER_NAME
+#define HPC_SOLVER_NAME "plugin"
+#endif
+
+//------------------------------------------------------------------------------
+/// 一緒にリンクした Answer の入口の表を返します。
+///
+/// Solver::Load が dlsym(HPC_SOLVER_ENTRY_SYMBOL) で探して呼び出します。
+/// 本体の Answer と名前が同じでも自分の Answer を呼ぶように、共有ライブラリは -Bsymbolic でリンクしてください。
+extern "C" const hpc::SolverEntry* HpcSolverEntry()
+{
+    static const hpc::SolverEntry entry = {
+        HPC_SOLVER_NAME,
+        "shared library built from Answer_bak/" HPC_SOLVER_NAME ".cpp",
+        &hpc::Answer::Init,
+        &hpc::Answer::InitPeriod,
+        &hpc::Answer::GetNextAction,
+        &hpc::Answer::FinalizePeriod,
+        &hpc::Answer::Finalize,
+    };
+    return &entry;
+}
+
+//------------------------------------------------------------------------------
+// EOF